@@ -0,0 +1,62 @@
+// Counts nt_fingerprint collisions among closely related sequences, the case that matters when
+// fingerprints stand in for nt_id to deduplicate sequences. Each sequence is one random 1.7 kb
+// sequence with 1 to 3 random substitutions plus a 12-base suffix spelling its index in base 4,
+// so all of them are distinct after standardization.
+//
+// Usage: fingerprint-collisions [count [seed]]   (defaults: 4000000 and 42)
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "udf-bioutils.h"
+
+// Number of values that repeat an earlier one once sorted
+template <typename T>
+std::size_t count_collisions(std::vector<T> &values) {
+    std::sort(values.begin(), values.end());
+    return values.size() - (std::unique(values.begin(), values.end()) - values.begin());
+}
+
+int main(int argc, char **argv) {
+    const std::size_t count  = argc > 1 ? std::strtoull(argv[1], NULL, 10) : 4000000;
+    const unsigned seed      = argc > 2 ? std::strtoul(argv[2], NULL, 10) : 42;
+    const std::size_t SUFFIX = 12;
+    const char BASES[]       = "ACGT";
+
+    std::mt19937_64 rng(seed);
+    std::string base(1700, 'A');
+    for (auto &c : base) {
+        c = BASES[rng() % 4];
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>> full(count);
+    std::vector<uint64_t> low(count);
+    std::string sequence;
+    for (std::size_t i = 0; i < count; i++) {
+        sequence = base;
+        for (int s = 0, n = 1 + rng() % 3; s < n; s++) {
+            char &c = sequence[rng() % base.size()];
+            c       = BASES[(std::string(BASES).find(c) + 1 + rng() % 3) % 4];
+        }
+        for (std::size_t k = 0; k < SUFFIX; k++) {
+            sequence += BASES[(i >> (2 * k)) & 3];
+        }
+
+        const StringVal seqVal(reinterpret_cast<uint8_t *>(sequence.data()), sequence.size());
+        const uint64_t hi = nt_fingerprint_hi(NULL, seqVal).val;
+        const uint64_t lo = nt_fingerprint_lo(NULL, seqVal).val;
+        full[i]           = {hi, lo};
+        low[i]            = lo;
+    }
+
+    std::cout << "sequences:             " << count << "\n"
+              << "128-bit collisions:    " << count_collisions(full) << "\n"
+              << "low 64-bit collisions: " << count_collisions(low) << "\n";
+    return 0;
+}
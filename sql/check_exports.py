@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""Checks that every SYMBOL and *_FN named in the CREATE statements is exported by its library.
+
+The libraries are built with -fvisibility=hidden, so a function missing IMPALA_UDF_EXPORT links
+into the unit tests but cannot be loaded by Impala.
+
+Usage: check_exports.py LIBRARY_DIR SQL_FILE...
+"""
+
+import os
+import re
+import subprocess
+import sys
+
+LOCATION = re.compile(r'LOCATION\s+"[^"]*?([^/"]+\.so)"', re.IGNORECASE)
+FUNCTION = re.compile(r'\b(SYMBOL|[A-Z]+_FN)\s*=\s*"([^"]+)"', re.IGNORECASE)
+
+
+def exported_names(library):
+    """Mangled and demangled (without parameters) names of the defined dynamic symbols."""
+    names = set()
+    for demangle in ([], ["-C"]):
+        output = subprocess.run(
+            ["nm", "-D", "--defined-only"] + demangle + [library],
+            check=True,
+            capture_output=True,
+            text=True,
+        ).stdout
+        for line in output.splitlines():
+            fields = line.split(" ", 2)
+            if len(fields) == 3:
+                names.add(fields[2].split("(", 1)[0])
+    return names
+
+
+def main(library_dir, sql_files):
+    exports = {}
+    missing = []
+    for sql_file in sql_files:
+        with open(sql_file) as f:
+            statements = f.read().split(";")
+        for statement in statements:
+            location = LOCATION.search(statement)
+            if location is None:
+                continue
+            library = location.group(1)
+            if library not in exports:
+                exports[library] = exported_names(os.path.join(library_dir, library))
+            for kind, name in FUNCTION.findall(statement):
+                if name not in exports[library]:
+                    missing.append(f"{sql_file}: {kind.upper()} {name} is not exported by {library}")
+
+    for line in missing:
+        print(line, file=sys.stderr)
+    return 1 if missing else 0
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 3:
+        print(__doc__, file=sys.stderr)
+        sys.exit(2)
+    sys.exit(main(sys.argv[1], sys.argv[2:]))
@@ -100,3 +100,53 @@ CREATE AGGREGATE FUNCTION IF NOT EXISTS udx.codon_entropy(STRING)
     MERGE_FN="CalcCDEntropyMerge"
     SERIALIZE_FN="CalcCDEntropySerialize"
     FINALIZE_FN="CalcCDEntropyFinalize";
+
+CREATE AGGREGATE FUNCTION IF NOT EXISTS udx.nt_distance_nearest(STRING, STRING)
+    RETURNS STRING
+    INTERMEDIATE STRING
+    LOCATION "$UDF_BIOUTILS_PATH/libudabioutils.so"
+    INIT_FN="PairwiseSeqInit"
+    UPDATE_FN="PairwiseSeqUpdate"
+    MERGE_FN="PairwiseSeqMerge"
+    SERIALIZE_FN="PairwiseSeqSerialize"
+    FINALIZE_FN="PairwiseNtNearestFinalize";
+
+CREATE AGGREGATE FUNCTION IF NOT EXISTS udx.nt_distance_matrix(STRING, STRING)
+    RETURNS STRING
+    INTERMEDIATE STRING
+    LOCATION "$UDF_BIOUTILS_PATH/libudabioutils.so"
+    INIT_FN="PairwiseSeqInit"
+    UPDATE_FN="PairwiseSeqUpdate"
+    MERGE_FN="PairwiseSeqMerge"
+    SERIALIZE_FN="PairwiseSeqSerialize"
+    FINALIZE_FN="PairwiseNtMatrixFinalize";
+
+CREATE AGGREGATE FUNCTION IF NOT EXISTS udx.sketch_union(STRING)
+    RETURNS STRING
+    INTERMEDIATE STRING
+    LOCATION "$UDF_BIOUTILS_PATH/libudabioutils.so"
+    INIT_FN="SketchUnionInit"
+    UPDATE_FN="SketchUnionUpdateMerge"
+    MERGE_FN="SketchUnionUpdateMerge"
+    SERIALIZE_FN="SketchUnionSerialize"
+    FINALIZE_FN="SketchUnionFinalize";
+
+CREATE AGGREGATE FUNCTION IF NOT EXISTS udx.epiweek_histogram(DATE)
+    RETURNS STRING
+    INTERMEDIATE STRING
+    LOCATION "$UDF_BIOUTILS_PATH/libudabioutils.so"
+    INIT_FN="EpiWeekHistogramInit"
+    UPDATE_FN="EpiWeekHistogramUpdate"
+    MERGE_FN="EpiWeekHistogramMerge"
+    SERIALIZE_FN="EpiWeekHistogramSerialize"
+    FINALIZE_FN="EpiWeekHistogramFinalize";
+
+CREATE AGGREGATE FUNCTION IF NOT EXISTS udx.epiweek_histogram(DATE, INT)
+    RETURNS STRING
+    INTERMEDIATE STRING
+    LOCATION "$UDF_BIOUTILS_PATH/libudabioutils.so"
+    INIT_FN="EpiWeekHistogramInit"
+    UPDATE_FN="EpiWeekHistogramUpdate"
+    MERGE_FN="EpiWeekHistogramMerge"
+    SERIALIZE_FN="EpiWeekHistogramSerialize"
+    FINALIZE_FN="EpiWeekHistogramFinalize";
@@ -4,6 +4,7 @@ create function if not exists udx.sort_list_set(string, string, string) returns
 create function if not exists udx.sort_alleles(string, string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Sort_Allele_List";
 create function if not exists udx.sort_site_list(string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Sort_Site_List";
 create function if not exists udx.to_aa(string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "To_AA";
+create function if not exists udx.to_aa_cached(string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "To_AA" PREPARE_FN = "Memo_Prepare" CLOSE_FN = "Memo_Close";
 create function if not exists udx.to_aa(string, string, int) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "To_AA_Mutant";
 create function if not exists udx.reverse_complement(string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Rev_Complement";
 create function if not exists udx.substr_range(string, string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Substring_By_Range";
@@ -11,17 +12,32 @@ create function if not exists udx.range_from_list(string, string) returns string
 create function if not exists udx.mutation_list_pds(string, string, string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Mutation_List_PDS";
 create function if not exists udx.mutation_list_gly(string, string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Mutation_List_Strict_GLY";
 create function if not exists udx.mutation_list_indel_gly(string, string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Mutation_List_Indel_GLY";
+create function if not exists udx.mutation_list_indel_gly_cached(string, string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Mutation_List_Indel_GLY" PREPARE_FN = "Memo_Prepare" CLOSE_FN = "Memo_Close";
 create function if not exists udx.mutation_list(string, string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Mutation_List_Strict";
 create function if not exists udx.mutation_list(string, string, string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Mutation_List_Strict_Range";
 create function if not exists udx.mutation_list_nt(string, string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Mutation_List_No_Ambiguous";
 create function if not exists udx.hamming_distance(string, string) returns int location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Hamming_Distance";
 create function if not exists udx.hamming_distance(string, string, string) returns int location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Hamming_Distance_Pairwise_Delete";
 create function if not exists udx.nt_distance(string, string) returns int location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Nt_Distance";
-create function if not exists udx.contains_element(string, string, string) returns boolean location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Contains_An_Element";
-create function if not exists udx.is_element(string, string, string) returns boolean location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Is_An_Element";
+create function if not exists udx.nearest_reference(string, string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Nearest_Reference" PREPARE_FN = "Nearest_Reference_Prepare" CLOSE_FN = "Nearest_Reference_Close";
+create function if not exists udx.contains_element(string, string, string) returns boolean location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Contains_An_Element" PREPARE_FN = "Contains_Element_Prepare" CLOSE_FN = "Contains_Element_Close";
+create function if not exists udx.is_element(string, string, string) returns boolean location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Is_An_Element" PREPARE_FN = "Is_Element_Prepare" CLOSE_FN = "Is_Element_Close";
 create function if not exists udx.contains_sym(string, string) returns boolean location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Contains_Symmetric";
+create function if not exists udx.contains_sym_ignore_case(string, string) returns boolean location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Contains_Symmetric_Ignore_Case";
 create function if not exists udx.nt_id(string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "nt_id";
+create function if not exists udx.nt_id_cached(string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "nt_id" PREPARE_FN = "Memo_Prepare" CLOSE_FN = "Memo_Close";
 create function if not exists udx.variant_hash(string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "variant_hash";
+create function if not exists udx.variant_hash_cached(string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "variant_hash" PREPARE_FN = "Memo_Prepare" CLOSE_FN = "Memo_Close";
+create function if not exists udx.nt_fingerprint(string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "nt_fingerprint";
+create function if not exists udx.nt_fingerprint_hi(string) returns bigint location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "nt_fingerprint_hi";
+create function if not exists udx.nt_fingerprint_lo(string) returns bigint location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "nt_fingerprint_lo";
+create function if not exists udx.aa_fingerprint(string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "aa_fingerprint";
+create function if not exists udx.aa_fingerprint_hi(string) returns bigint location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "aa_fingerprint_hi";
+create function if not exists udx.aa_fingerprint_lo(string) returns bigint location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "aa_fingerprint_lo";
+create function if not exists udx.nt_sketch(string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Nt_Sketch";
+create function if not exists udx.nt_sketch(string, int, int) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Nt_Sketch_K_S";
+create function if not exists udx.sketch_similarity(string, string) returns double location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Sketch_Similarity";
+create function if not exists udx.sketch_distance(string, string) returns double location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Sketch_Distance";
 create function if not exists udx.complete_date(string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Complete_String_Date";
 create function if not exists udx.md5(string...) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" symbol = "md5";
 create function if not exists udx.longest_deletion(string) returns int location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Longest_Deletion";
@@ -32,13 +48,23 @@ create function if not exists udx.pcd_list(string, string) returns string locati
 create function if not exists udx.pcd(string, string) returns double location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Physiochemical_Distance";
 create function if not exists udx.tn_93(string, string) returns double location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Tn_93_Distance";
 create function if not exists udx.tn_93(string, string, double) returns double location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Tn_93_Gamma";
-create function if not exists udx.any_instr(string, string) returns boolean location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Find_Set_In_String";
-create function if not exists udx.to_epiweek(string, boolean) returns int location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Convert_String_To_EPI_Week";
-create function if not exists udx.to_epiweek(string) returns int location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Convert_String_To_EPI_Week";
+create function if not exists udx.nt_pack(string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "NT_Pack";
+create function if not exists udx.nt_pack(string, int) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "NT_Pack_Bits";
+create function if not exists udx.nt_unpack(string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "NT_Unpack";
+create function if not exists udx.nt_distance_packed(string, string) returns int location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Nt_Distance_Packed";
+create function if not exists udx.hamming_distance_packed(string, string) returns int location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Hamming_Distance_Packed";
+create function if not exists udx.tn_93_packed(string, string) returns double location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Tn_93_Distance_Packed";
+create function if not exists udx.align_to_reference(string, string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Align_To_Reference";
+create function if not exists udx.align_to_reference(string, string, int) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Align_To_Reference_Band";
+create function if not exists udx.alignment_insertions(string, string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Alignment_Insertions";
+create function if not exists udx.alignment_insertions(string, string, int) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Alignment_Insertions_Band";
+create function if not exists udx.any_instr(string, string) returns boolean location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Find_Set_In_String" PREPARE_FN = "Find_Set_Prepare" CLOSE_FN = "Find_Set_Close";
+create function if not exists udx.to_epiweek(string, boolean) returns int location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Convert_String_To_EPI_Week" PREPARE_FN = "Date_Parse_Prepare" CLOSE_FN = "Date_Parse_Close";
+create function if not exists udx.to_epiweek(string) returns int location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Convert_String_To_EPI_Week" PREPARE_FN = "Date_Parse_Prepare" CLOSE_FN = "Date_Parse_Close";
 create function if not exists udx.to_epiweek(timestamp, boolean) returns int location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Convert_Timestamp_To_EPI_Week";
 create function if not exists udx.to_epiweek(timestamp) returns int location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Convert_Timestamp_To_EPI_Week";
-create function if not exists udx.cut_paste(string, string, string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Cut_Paste";
-create function if not exists udx.cut_paste(string, string, string, string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Cut_Paste_Output";
+create function if not exists udx.cut_paste(string, string, string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Cut_Paste" PREPARE_FN = "Cut_Paste_Prepare" CLOSE_FN = "Cut_Paste_Close";
+create function if not exists udx.cut_paste(string, string, string, string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Cut_Paste_Output" PREPARE_FN = "Cut_Paste_Prepare" CLOSE_FN = "Cut_Paste_Close";
 create function if not exists udx.og_pos_to_aa3_mutation(string, string, string, bigint, string, string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "NT_Position_To_Mutation_AA3";
 create function if not exists udx.og_to_aa_position(string, string, bigint) returns int location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "NT_To_AA_Position";
 create function if not exists udx.og_to_cds_position(string, string, bigint) returns int location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "NT_To_CDS_Position";
@@ -46,16 +72,20 @@ create function if not exists udx.codon_at_og_position(string, string, string, b
 create function if not exists udx.codon_at_og_position(string, string, string, bigint, string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "NT_Position_To_CDS_Codon_Mutant";
 create function if not exists udx.fortnight_date(date, boolean) returns date location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Fortnight_Date_Either";
 create function if not exists udx.fortnight_date(date) returns date location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Fortnight_Date";
-create function if not exists udx.fortnight_date(string, boolean) returns date location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Fortnight_Date_Either_STR";
-create function if not exists udx.fortnight_date(string) returns date location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Fortnight_Date_STR";
+create function if not exists udx.fortnight_date(string, boolean) returns date location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Fortnight_Date_Either_STR" PREPARE_FN = "Date_Parse_Prepare" CLOSE_FN = "Date_Parse_Close";
+create function if not exists udx.fortnight_date(string) returns date location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Fortnight_Date_STR" PREPARE_FN = "Date_Parse_Prepare" CLOSE_FN = "Date_Parse_Close";
 create function if not exists udx.fortnight_date(timestamp, boolean) returns date location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Fortnight_Date_Either_TS";
 create function if not exists udx.fortnight_date(timestamp) returns date location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Fortnight_Date_TS";
+create function if not exists udx.period_ending_date(date, int, date) returns date location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Period_Ending_Date" PREPARE_FN = "Period_Ending_Prepare" CLOSE_FN = "Period_Ending_Close";
+create function if not exists udx.period_ending_date(string, int, date) returns date location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Period_Ending_Date_STR" PREPARE_FN = "Period_Ending_Prepare" CLOSE_FN = "Period_Ending_Close";
+create function if not exists udx.period_ending_date(timestamp, int, date) returns date location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Period_Ending_Date_TS" PREPARE_FN = "Period_Ending_Prepare" CLOSE_FN = "Period_Ending_Close";
 create function if not exists udx.saturday_date(date) returns date location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Date_Ending_In_Saturday_DATE";
-create function if not exists udx.saturday_date(string) returns date location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Date_Ending_In_Saturday_STR";
+create function if not exists udx.saturday_date(string) returns date location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Date_Ending_In_Saturday_STR" PREPARE_FN = "Date_Parse_Prepare" CLOSE_FN = "Date_Parse_Close";
 create function if not exists udx.saturday_date(timestamp) returns date location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Date_Ending_In_Saturday_TS";
 create function if not exists udx.date_to_decimal(date) returns double location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Date_to_Double";
 create function if not exists udx.decimal_to_date(double) returns date location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Double_to_Date";
 create function if not exists udx.to_aa3(string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "To_AA3";
+create function if not exists udx.to_aa3_cached(string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "To_AA3" PREPARE_FN = "Memo_Prepare" CLOSE_FN = "Memo_Close";
 create function if not exists udx.sequence_diff(string, string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Sequence_Diff";
 create function if not exists udx.sequence_diff_nt(string, string) returns string location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Sequence_Diff_NT";
 create function if not exists udx.alnum_entropy(string) returns double location "$UDF_BIOUTILS_PATH/libudfbioutils.so" SYMBOL = "Calculate_Entropy";
\ No newline at end of file
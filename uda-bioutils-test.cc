@@ -5,6 +5,7 @@
 
 #include "uda-bioutils.h"
 #include <impala_udf/uda-test-harness.h>
+#include <impala_udf/udf-test-harness.h>
 #include <impala_udf/udf.h>
 
 using namespace impala;
@@ -255,6 +256,143 @@ bool TestCDEntropy() {
     return passing;
 }
 
+bool TestPairwiseNtDistance() {
+    typedef UdaTestHarness2<StringVal, StringVal, StringVal, StringVal> TestHarness;
+    TestHarness nearest(
+        PairwiseSeqInit, PairwiseSeqUpdate, PairwiseSeqMerge,
+        reinterpret_cast<TestHarness::SerializeFn>(PairwiseSeqSerialize), PairwiseNtNearestFinalize
+    );
+    TestHarness matrix(
+        PairwiseSeqInit, PairwiseSeqUpdate, PairwiseSeqMerge,
+        reinterpret_cast<TestHarness::SerializeFn>(PairwiseSeqSerialize), PairwiseNtMatrixFinalize
+    );
+    bool passing = true;
+
+    // Fewer than two sequences has no pairs
+    vector<StringVal> ids  = {StringVal("a")};
+    vector<StringVal> seqs = {StringVal("ACGT")};
+    if (!nearest.Execute(ids, seqs, StringVal::null())) {
+        cerr << "Pairwise nt nearest (singleton): " << nearest.GetErrorMsg() << endl;
+        passing = false;
+    }
+
+    // Input order should not matter, ambiguous resolvable differences are not counted
+    ids  = {StringVal("c"), StringVal("a"), StringVal("b"), StringVal("d")};
+    seqs = {StringVal("ACGTAA"), StringVal("ACGTTT"), StringVal("ACRTTA"), StringVal("")};
+    if (!nearest.Execute(ids, seqs, StringVal("a:b:1, b:a:1, c:b:1"))) {
+        cerr << "Pairwise nt nearest: " << nearest.GetErrorMsg() << endl;
+        passing = false;
+    }
+
+    if (!matrix.Execute(ids, seqs, StringVal("a,b,c;1,2,1"))) {
+        cerr << "Pairwise nt matrix: " << matrix.GetErrorMsg() << endl;
+        passing = false;
+    }
+
+    return passing;
+}
+
+bool TestSketchUnion() {
+    typedef UdaTestHarness<StringVal, StringVal, StringVal> TestHarness;
+    TestHarness sketch_union(
+        SketchUnionInit, SketchUnionUpdateMerge, SketchUnionUpdateMerge,
+        reinterpret_cast<TestHarness::SerializeFn>(SketchUnionSerialize), SketchUnionFinalize
+    );
+    bool passing = true;
+
+    // k = 4 sketches of hashes {1, 3}, {2, 3} and {4} with s = 2, 4 and 4
+    const std::string header_s2("\x04\x02\x00\x00\x00", 5);
+    const std::string header_s4("\x04\x04\x00\x00\x00", 5);
+    const std::string h1("\x01\x00\x00\x00\x00\x00\x00\x00", 8);
+    const std::string h2("\x02\x00\x00\x00\x00\x00\x00\x00", 8);
+    const std::string h3("\x03\x00\x00\x00\x00\x00\x00\x00", 8);
+    const std::string h4("\x04\x00\x00\x00\x00\x00\x00\x00", 8);
+    const std::string a        = header_s2 + h1 + h3;
+    const std::string b        = header_s4 + h2 + h3;
+    const std::string c        = header_s4 + h4;
+    const std::string expected = header_s2 + h1 + h2;
+
+    vector<StringVal> vals;
+    if (!sketch_union.Execute(vals, StringVal::null())) {
+        cerr << "Sketch union (empty): " << sketch_union.GetErrorMsg() << endl;
+        passing = false;
+    }
+
+    // The smaller sketch size is kept and nulls or invalid sketches are ignored
+    vals = {
+        StringVal((uint8_t *)a.data(), a.size()), StringVal::null(),
+        StringVal((uint8_t *)b.data(), b.size()), StringVal("ACGT"),
+        StringVal((uint8_t *)c.data(), c.size())
+    };
+    if (!sketch_union.Execute(vals, StringVal((uint8_t *)expected.data(), expected.size()))) {
+        cerr << "Sketch union: " << sketch_union.GetErrorMsg() << endl;
+        passing = false;
+    }
+
+    return passing;
+}
+
+bool TestEpiWeekHistogram() {
+    typedef UdaTestHarness<StringVal, StringVal, DateVal> TestHarness;
+    typedef UdaTestHarness2<StringVal, StringVal, DateVal, IntVal> TestHarness2;
+    TestHarness histogram(
+        EpiWeekHistogramInit, EpiWeekHistogramUpdate, EpiWeekHistogramMerge,
+        EpiWeekHistogramSerialize, EpiWeekHistogramFinalize
+    );
+    TestHarness2 histogram_from(
+        EpiWeekHistogramInit, EpiWeekHistogramUpdate, EpiWeekHistogramMerge,
+        EpiWeekHistogramSerialize, EpiWeekHistogramFinalize
+    );
+    bool passing = true;
+
+    vector<DateVal> dates;
+    if (!histogram.Execute(dates, StringVal::null())) {
+        cerr << "Epi week histogram (empty): " << histogram.GetErrorMsg() << endl;
+        passing = false;
+    }
+
+    // Days since 1970-01-01 for 2023-12-31, 2024-01-06, 2024-01-07, 2020-12-31, 2021-01-02,
+    // 1985-06-01 and 2024-12-29
+    dates = {
+        DateVal(19722), DateVal(19728), DateVal(19729), DateVal::null(),
+        DateVal(18627), DateVal(18629), DateVal(5630),  DateVal(20086)
+    };
+    if (!histogram.Execute(
+            dates, StringVal("202053:2, 202401:2, 202402:1, 202501:1, other:1")
+        )) {
+        cerr << "Epi week histogram: " << histogram.GetErrorMsg() << endl;
+        passing = false;
+    }
+
+    vector<IntVal> first_years(dates.size(), IntVal(2021));
+    if (!histogram_from.Execute(
+            dates, first_years, StringVal("202401:2, 202402:1, 202501:1, other:3")
+        )) {
+        cerr << "Epi week histogram from 2021: " << histogram_from.GetErrorMsg() << endl;
+        passing = false;
+    }
+
+    // A group with a single week serializes the 24-byte header and one bin
+    FunctionContext::TypeDesc string_type, date_type;
+    string_type.type         = FunctionContext::TYPE_STRING;
+    date_type.type           = FunctionContext::TYPE_DATE;
+    FunctionContext *context = UdfTestHarness::CreateTestContext(string_type, {date_type});
+    StringVal state;
+    EpiWeekHistogramInit(context, &state);
+    EpiWeekHistogramUpdate(context, DateVal(19728), &state);
+    EpiWeekHistogramUpdate(context, DateVal(19722), &state);
+    const StringVal serialized = EpiWeekHistogramSerialize(context, state);
+    if (serialized.len != 32) {
+        cerr << "Epi week histogram: single week serialized to " << serialized.len << " bytes"
+             << endl;
+        passing = false;
+    }
+    context->Free(serialized.ptr);
+    UdfTestHarness::CloseContext(context);
+
+    return passing;
+}
+
 int main(int argc, char **argv) {
     bool passed = true;
     passed &= TestAgreement();
@@ -264,6 +402,9 @@ int main(int argc, char **argv) {
     passed &= TestNTEntropy();
     passed &= TestAAEntropy();
     passed &= TestCDEntropy();
+    passed &= TestPairwiseNtDistance();
+    passed &= TestSketchUnion();
+    passed &= TestEpiWeekHistogram();
     cerr << (passed ? "Tests passed." : "Tests failed.") << endl;
     return 0;
 }
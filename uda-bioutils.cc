@@ -6,9 +6,16 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstddef>
 #include <cstring>
 #include <limits>
 #include <string>
+#include <string_view>
+#include <vector>
+
+#include "udx-calendar.h"
+#include "udx-matrix.h"
+#include "udx-sketch.h"
 
 
 using namespace impala_udf;
@@ -1020,3 +1027,558 @@ DoubleVal CalcCDEntropyFinalize(FunctionContext *context, const StringVal &val)
     context->Free(val.ptr);
     return DoubleVal(sum);
 }
+
+
+// ---------------------------------------------------------------------------
+// Pairwise Nucleotide Distance Aggregate Functions
+// ---------------------------------------------------------------------------
+
+// The intermediate buffer is a header followed by packed records of the form
+// [id_len][seq_len][id bytes][seq bytes]. The StringVal length tracks the bytes in use while the
+// header tracks the allocated capacity. Groups that exceed the budget are flagged and finalize to
+// null rather than returning a partial matrix.
+struct PairwiseSeqHeader {
+    static const int64_t BUDGET = 64 * 1024 * 1024;
+    uint32_t n;
+    uint32_t overflow;
+    int64_t capacity;
+};
+
+struct PairwiseSeqRecord {
+    uint32_t id_len;
+    uint32_t seq_len;
+};
+
+struct PairwiseSeqEntry {
+    std::string_view id;
+    const uint8_t *seq;
+    uint32_t len;
+};
+
+// Number of sequences per tile in the all-vs-all loop, sized so two tiles of typical gene-length
+// sequences stay resident in L2.
+const std::size_t PAIRWISE_TILE = 32;
+
+inline bool pairwise_seq_reserve(FunctionContext *context, StringVal *val, int64_t needed) {
+    PairwiseSeqHeader *h = reinterpret_cast<PairwiseSeqHeader *>(val->ptr);
+    int64_t required     = static_cast<int64_t>(val->len) + needed;
+
+    if (required > PairwiseSeqHeader::BUDGET) {
+        if (h->overflow == 0) {
+            context->AddWarning("Pairwise distance memory budget exceeded, group result is NULL.");
+        }
+        h->overflow = 1;
+        return false;
+    }
+
+    if (required > h->capacity) {
+        int64_t capacity = std::min(std::max(h->capacity * 2, required), PairwiseSeqHeader::BUDGET);
+        uint8_t *ptr     = context->Reallocate(val->ptr, capacity);
+        if (ptr == NULL) {
+            h->overflow = 1;
+            return false;
+        }
+        val->ptr = ptr;
+        h        = reinterpret_cast<PairwiseSeqHeader *>(val->ptr);
+        h->capacity = capacity;
+    }
+
+    return true;
+}
+
+inline void pairwise_seq_append(
+    FunctionContext *context, const uint8_t *id, uint32_t id_len, const uint8_t *seq,
+    uint32_t seq_len, StringVal *val
+) {
+    if (!pairwise_seq_reserve(context, val, sizeof(PairwiseSeqRecord) + id_len + seq_len)) {
+        return;
+    }
+
+    uint8_t *p            = val->ptr + val->len;
+    PairwiseSeqRecord rec = {id_len, seq_len};
+    memcpy(p, &rec, sizeof(PairwiseSeqRecord));
+    memcpy(p + sizeof(PairwiseSeqRecord), id, id_len);
+    memcpy(p + sizeof(PairwiseSeqRecord) + id_len, seq, seq_len);
+
+    val->len += sizeof(PairwiseSeqRecord) + id_len + seq_len;
+    reinterpret_cast<PairwiseSeqHeader *>(val->ptr)->n++;
+}
+
+// Unpacks the records and sorts them by id so that output is independent of merge order.
+inline std::vector<PairwiseSeqEntry> pairwise_seq_entries(const StringVal &val) {
+    const PairwiseSeqHeader *h = reinterpret_cast<const PairwiseSeqHeader *>(val.ptr);
+    std::vector<PairwiseSeqEntry> entries;
+    entries.reserve(h->n);
+
+    const uint8_t *p    = val.ptr + sizeof(PairwiseSeqHeader);
+    const uint8_t *last = val.ptr + val.len;
+    while (p < last) {
+        PairwiseSeqRecord rec;
+        memcpy(&rec, p, sizeof(PairwiseSeqRecord));
+        p += sizeof(PairwiseSeqRecord);
+        entries.push_back(
+            {std::string_view((const char *)p, rec.id_len), p + rec.id_len, rec.seq_len}
+        );
+        p += rec.id_len + rec.seq_len;
+    }
+
+    std::stable_sort(entries.begin(), entries.end(), [](const auto &a, const auto &b) {
+        return a.id < b.id;
+    });
+    return entries;
+}
+
+// Same kernel as Nt_Distance: ambiguity-aware mismatches over the shorter length.
+inline int pairwise_nt_distance(const PairwiseSeqEntry &a, const PairwiseSeqEntry &b) {
+    return nt_distance_bounded(a.seq, b.seq, std::min(a.len, b.len));
+}
+
+// Visits each unordered pair (i < j) once, tile by tile, so that each block of sequences is
+// reused from cache against its partner block before moving on.
+template <typename F>
+inline void pairwise_tiled(const std::vector<PairwiseSeqEntry> &entries, F &&visit) {
+    const std::size_t N = entries.size();
+    for (std::size_t bi = 0; bi < N; bi += PAIRWISE_TILE) {
+        const std::size_t ei = std::min(bi + PAIRWISE_TILE, N);
+        for (std::size_t bj = bi; bj < N; bj += PAIRWISE_TILE) {
+            const std::size_t ej = std::min(bj + PAIRWISE_TILE, N);
+            for (std::size_t i = bi; i < ei; i++) {
+                for (std::size_t j = std::max(bj, i + 1); j < ej; j++) {
+                    visit(i, j, pairwise_nt_distance(entries[i], entries[j]));
+                }
+            }
+        }
+    }
+}
+
+IMPALA_UDF_EXPORT
+void PairwiseSeqInit(FunctionContext *context, StringVal *val) {
+    const int64_t capacity = 4096;
+    val->ptr               = context->Allocate(capacity);
+
+    if (val->ptr == NULL) {
+        *val = StringVal::null();
+        return;
+    }
+
+    val->is_null = false;
+    val->len     = sizeof(PairwiseSeqHeader);
+
+    PairwiseSeqHeader *h = reinterpret_cast<PairwiseSeqHeader *>(val->ptr);
+    h->n                 = 0;
+    h->overflow          = 0;
+    h->capacity          = capacity;
+}
+
+IMPALA_UDF_EXPORT
+void PairwiseSeqUpdate(
+    FunctionContext *context, const StringVal &id, const StringVal &seq, StringVal *val
+) {
+    if (id.is_null || seq.is_null || seq.len == 0 || val->is_null) {
+        return;
+    }
+    if (reinterpret_cast<PairwiseSeqHeader *>(val->ptr)->overflow) {
+        return;
+    }
+
+    pairwise_seq_append(context, id.ptr, id.len, seq.ptr, seq.len, val);
+}
+
+IMPALA_UDF_EXPORT
+void PairwiseSeqMerge(FunctionContext *context, const StringVal &src, StringVal *dst) {
+    if (src.is_null || dst->is_null) {
+        return;
+    }
+
+    const PairwiseSeqHeader *src_h = reinterpret_cast<const PairwiseSeqHeader *>(src.ptr);
+    PairwiseSeqHeader *dst_h       = reinterpret_cast<PairwiseSeqHeader *>(dst->ptr);
+    if (src_h->overflow) {
+        dst_h->overflow = 1;
+        return;
+    }
+
+    int64_t needed = src.len - sizeof(PairwiseSeqHeader);
+    if (needed == 0 || dst_h->overflow || !pairwise_seq_reserve(context, dst, needed)) {
+        return;
+    }
+
+    memcpy(dst->ptr + dst->len, src.ptr + sizeof(PairwiseSeqHeader), needed);
+    dst->len += needed;
+    reinterpret_cast<PairwiseSeqHeader *>(dst->ptr)->n += src_h->n;
+}
+
+IMPALA_UDF_EXPORT
+StringVal PairwiseSeqSerialize(FunctionContext *context, const StringVal &val) {
+    if (val.is_null) {
+        return StringVal::null();
+    }
+
+    StringVal result = StringVal::CopyFrom(context, val.ptr, val.len);
+    if (!result.is_null) {
+        reinterpret_cast<PairwiseSeqHeader *>(result.ptr)->capacity = result.len;
+    }
+    context->Free(val.ptr);
+    return result;
+}
+
+// Nearest neighbour summary: "id:nearest_id:distance" for each sequence, comma-space delimited and
+// ordered by id. Ties go to the first id in sort order.
+IMPALA_UDF_EXPORT
+StringVal PairwiseNtNearestFinalize(FunctionContext *context, const StringVal &val) {
+    if (val.is_null) {
+        return StringVal::null();
+    }
+
+    const PairwiseSeqHeader *h = reinterpret_cast<const PairwiseSeqHeader *>(val.ptr);
+    if (h->overflow || h->n < 2) {
+        context->Free(val.ptr);
+        return StringVal::null();
+    }
+
+    auto entries = pairwise_seq_entries(val);
+    std::vector<int> best_d(entries.size(), std::numeric_limits<int>::max());
+    std::vector<std::size_t> best_j(entries.size(), 0);
+
+    pairwise_tiled(entries, [&](std::size_t i, std::size_t j, int d) {
+        if (d < best_d[i] || (d == best_d[i] && j < best_j[i])) {
+            best_d[i] = d;
+            best_j[i] = j;
+        }
+        if (d < best_d[j] || (d == best_d[j] && i < best_j[j])) {
+            best_d[j] = d;
+            best_j[j] = i;
+        }
+    });
+
+    std::string buffer = "";
+    for (std::size_t i = 0; i < entries.size(); i++) {
+        if (i > 0) {
+            buffer += ", ";
+        }
+        buffer += entries[i].id;
+        buffer += ":";
+        buffer += entries[best_j[i]].id;
+        buffer += ":" + std::to_string(best_d[i]);
+    }
+
+    StringVal result = to_StringVal(context, buffer);
+    context->Free(val.ptr);
+    return result;
+}
+
+// Condensed matrix: the sorted ids (comma delimited), a semi-colon, and then the upper triangle of
+// distances in row-major order (comma delimited), i.e. d(1,2),d(1,3),...,d(2,3),...
+IMPALA_UDF_EXPORT
+StringVal PairwiseNtMatrixFinalize(FunctionContext *context, const StringVal &val) {
+    if (val.is_null) {
+        return StringVal::null();
+    }
+
+    const PairwiseSeqHeader *h = reinterpret_cast<const PairwiseSeqHeader *>(val.ptr);
+    if (h->overflow || h->n < 2) {
+        context->Free(val.ptr);
+        return StringVal::null();
+    }
+
+    auto entries        = pairwise_seq_entries(val);
+    const std::size_t N = entries.size();
+    std::vector<int> condensed(N * (N - 1) / 2, 0);
+
+    // Row i of the condensed matrix starts at i*N - i*(i+1)/2 and column j is offset by j - i - 1
+    pairwise_tiled(entries, [&](std::size_t i, std::size_t j, int d) {
+        condensed[i * N - i * (i + 1) / 2 + (j - i - 1)] = d;
+    });
+
+    std::string buffer = "";
+    for (std::size_t i = 0; i < N; i++) {
+        if (i > 0) {
+            buffer += ",";
+        }
+        buffer += entries[i].id;
+    }
+    buffer += ";";
+    for (std::size_t k = 0; k < condensed.size(); k++) {
+        if (k > 0) {
+            buffer += ",";
+        }
+        buffer += std::to_string(condensed[k]);
+    }
+
+    StringVal result = to_StringVal(context, buffer);
+    context->Free(val.ptr);
+    return result;
+}
+
+
+// ---------------------------------------------------------------------------
+// MinHash Sketch Union
+// ---------------------------------------------------------------------------
+
+// Sketches are combined by keeping the bottom-s of their union, where s is the smaller sketch size.
+// Sketches with a different k-mer length than the first one seen are ignored.
+IMPALA_UDF_EXPORT
+void SketchUnionInit(FunctionContext *context, StringVal *val) {
+    val->is_null = true;
+    val->ptr     = NULL;
+    val->len     = 0;
+}
+
+IMPALA_UDF_EXPORT
+void SketchUnionUpdateMerge(FunctionContext *context, const StringVal &src, StringVal *dst) {
+    SketchView a;
+    if (!sketch_view(src, a)) {
+        return;
+    }
+
+    if (dst->is_null) {
+        dst->ptr = context->Allocate(src.len);
+        if (dst->ptr == NULL) {
+            return;
+        }
+        memcpy(dst->ptr, src.ptr, src.len);
+        dst->len     = src.len;
+        dst->is_null = false;
+        return;
+    }
+
+    SketchView b;
+    if (!sketch_view(*dst, b)) {
+        context->AddWarning("Sketch ignored because the intermediate sketch is malformed.");
+        return;
+    }
+    if (a.k != b.k) {
+        context->AddWarning("Sketch ignored because its k-mer length differs.");
+        return;
+    }
+
+    const uint32_t s               = std::min(a.s, b.s);
+    uint32_t shared                = 0;
+    std::vector<uint64_t> in_union = sketch_union(a, b, s, shared);
+
+    uint8_t *ptr = context->Allocate(sketch_bytes(in_union.size()));
+    if (ptr == NULL) {
+        return;
+    }
+    write_sketch(ptr, b.k, s, in_union);
+    context->Free(dst->ptr);
+    dst->ptr = ptr;
+    dst->len = sketch_bytes(in_union.size());
+}
+
+IMPALA_UDF_EXPORT
+StringVal SketchUnionSerialize(FunctionContext *context, const StringVal &val) {
+    if (val.is_null) {
+        return StringVal::null();
+    }
+
+    StringVal result = StringVal::CopyFrom(context, val.ptr, val.len);
+    context->Free(val.ptr);
+    return result;
+}
+
+IMPALA_UDF_EXPORT
+StringVal SketchUnionFinalize(FunctionContext *context, const StringVal &val) {
+    return SketchUnionSerialize(context, val);
+}
+
+
+// ---------------------------------------------------------------------------
+// Epi Week Histogram
+// ---------------------------------------------------------------------------
+
+// Dense counts per epi week over YEARS years from first_year, so that weekly case counts can be
+// aggregated without grouping by week. Bins are 53 per year (week 53 is empty in most years) and
+// dates of epi years outside the span are counted in `other`. Serialization keeps only the bins
+// from `lower` to `upper` so sparse states stay small in the exchange; `offset` is the bin stored
+// first, which is 0 for states that hold every bin.
+struct EpiWeekHistogramStruct {
+    static const int YEARS              = 64;
+    static const int WEEKS              = 53;
+    static const int BINS               = YEARS * WEEKS;
+    static const int DEFAULT_FIRST_YEAR = 1990;
+    int32_t first_year;
+    int32_t lower;
+    int32_t upper;
+    int32_t offset;
+    uint64_t other;
+    uint64_t counts[BINS];
+};
+
+const std::size_t EPI_HIST_HEADER = offsetof(EpiWeekHistogramStruct, counts);
+
+inline bool epiweek_histogram_empty(const EpiWeekHistogramStruct *ewh) {
+    return ewh->upper < 0 && ewh->other == 0;
+}
+
+// Last bin held by a (possibly serialized) state
+inline int32_t epiweek_histogram_upper(const StringVal &val) {
+    const EpiWeekHistogramStruct *ewh = reinterpret_cast<const EpiWeekHistogramStruct *>(val.ptr);
+    const int32_t stored = static_cast<int32_t>((val.len - EPI_HIST_HEADER) / sizeof(uint64_t));
+    return std::min(ewh->upper, ewh->offset + stored - 1);
+}
+
+inline uint64_t epiweek_histogram_count(const EpiWeekHistogramStruct *ewh, int32_t bin) {
+    return ewh->counts[bin - ewh->offset];
+}
+
+inline void epiweek_histogram_add(EpiWeekHistogramStruct *ewh, int32_t days) {
+    const epiweek_t epi = days_to_epiweek(days);
+    const int64_t bin =
+        (static_cast<int64_t>(epi.year) - ewh->first_year) * ewh->WEEKS + epi.week - 1;
+    if (bin < 0 || bin >= ewh->BINS) {
+        ewh->other++;
+        return;
+    }
+
+    ewh->counts[bin]++;
+    ewh->lower = std::min(ewh->lower, static_cast<int32_t>(bin));
+    ewh->upper = std::max(ewh->upper, static_cast<int32_t>(bin));
+}
+
+IMPALA_UDF_EXPORT
+void EpiWeekHistogramInit(FunctionContext *context, StringVal *val) {
+    val->ptr = context->Allocate(sizeof(EpiWeekHistogramStruct));
+    if (val->ptr == NULL) {
+        *val = StringVal::null();
+        return;
+    }
+
+    val->is_null = false;
+    val->len     = sizeof(EpiWeekHistogramStruct);
+    memset(val->ptr, 0, val->len);
+
+    EpiWeekHistogramStruct *ewh = reinterpret_cast<EpiWeekHistogramStruct *>(val->ptr);
+    ewh->first_year             = ewh->DEFAULT_FIRST_YEAR;
+    ewh->lower                  = ewh->BINS;
+    ewh->upper                  = -1;
+}
+
+IMPALA_UDF_EXPORT
+void EpiWeekHistogramUpdate(FunctionContext *context, const DateVal &date, StringVal *val) {
+    if (date.is_null || val->is_null) {
+        return;
+    }
+    epiweek_histogram_add(reinterpret_cast<EpiWeekHistogramStruct *>(val->ptr), date.val);
+}
+
+// The first year of the span is taken from the first row and is expected to be constant
+IMPALA_UDF_EXPORT
+void EpiWeekHistogramUpdate(
+    FunctionContext *context, const DateVal &date, const IntVal &first_year, StringVal *val
+) {
+    if (date.is_null || val->is_null) {
+        return;
+    }
+
+    EpiWeekHistogramStruct *ewh = reinterpret_cast<EpiWeekHistogramStruct *>(val->ptr);
+    if (!first_year.is_null && epiweek_histogram_empty(ewh)) {
+        ewh->first_year = first_year.val;
+    }
+    epiweek_histogram_add(ewh, date.val);
+}
+
+// Spans starting in different years are aligned by whole years; bins that fall outside of the
+// destination's span are moved to `other`.
+IMPALA_UDF_EXPORT
+void EpiWeekHistogramMerge(FunctionContext *context, const StringVal &src, StringVal *dst) {
+    if (src.is_null || dst->is_null) {
+        return;
+    }
+
+    const EpiWeekHistogramStruct *src_ewh =
+        reinterpret_cast<const EpiWeekHistogramStruct *>(src.ptr);
+    EpiWeekHistogramStruct *dst_ewh = reinterpret_cast<EpiWeekHistogramStruct *>(dst->ptr);
+    if (epiweek_histogram_empty(src_ewh)) {
+        return;
+    }
+    if (epiweek_histogram_empty(dst_ewh)) {
+        dst_ewh->first_year = src_ewh->first_year;
+    }
+
+    dst_ewh->other += src_ewh->other;
+    const int32_t upper = epiweek_histogram_upper(src);
+    const int64_t shift =
+        (static_cast<int64_t>(src_ewh->first_year) - dst_ewh->first_year) * dst_ewh->WEEKS;
+    const int32_t lo = std::max<int64_t>(src_ewh->lower, -shift);
+    const int32_t hi = std::min<int64_t>(upper, dst_ewh->BINS - 1 - shift);
+
+    for (int32_t i = src_ewh->lower; i <= upper && i < lo; i++) {
+        dst_ewh->other += epiweek_histogram_count(src_ewh, i);
+    }
+    for (int32_t i = std::max(hi + 1, src_ewh->lower); i <= upper; i++) {
+        dst_ewh->other += epiweek_histogram_count(src_ewh, i);
+    }
+    if (lo > hi) {
+        return;
+    }
+
+    // Plain element-wise add over the overlap, which the compiler vectorizes
+    uint64_t *out      = dst_ewh->counts + lo + shift;
+    const uint64_t *in = src_ewh->counts + lo - src_ewh->offset;
+    for (int32_t i = 0; i <= hi - lo; i++) {
+        out[i] += in[i];
+    }
+    dst_ewh->lower = std::min<int32_t>(dst_ewh->lower, lo + shift);
+    dst_ewh->upper = std::max<int32_t>(dst_ewh->upper, hi + shift);
+}
+
+IMPALA_UDF_EXPORT
+StringVal EpiWeekHistogramSerialize(FunctionContext *context, const StringVal &val) {
+    if (val.is_null) {
+        return StringVal::null();
+    }
+
+    const EpiWeekHistogramStruct *ewh = reinterpret_cast<const EpiWeekHistogramStruct *>(val.ptr);
+    const int32_t upper = epiweek_histogram_upper(val);
+    const int32_t bins  = std::max(upper - ewh->lower + 1, 0);
+    StringVal result(context, EPI_HIST_HEADER + bins * sizeof(uint64_t));
+    if (result.is_null) {
+        context->Free(val.ptr);
+        return result;
+    }
+
+    EpiWeekHistogramStruct *out = reinterpret_cast<EpiWeekHistogramStruct *>(result.ptr);
+    memcpy(out, ewh, EPI_HIST_HEADER);
+    if (bins > 0) {
+        out->offset = ewh->lower;
+        memcpy(out->counts, ewh->counts + ewh->lower - ewh->offset, bins * sizeof(uint64_t));
+    }
+    context->Free(val.ptr);
+    return result;
+}
+
+// Returns "yyyyww:count" for each epi week with cases in ascending order, followed by
+// "other:count" for dates outside of the span if there were any.
+IMPALA_UDF_EXPORT
+StringVal EpiWeekHistogramFinalize(FunctionContext *context, const StringVal &val) {
+    if (val.is_null) {
+        return StringVal::null();
+    }
+
+    const EpiWeekHistogramStruct *ewh = reinterpret_cast<const EpiWeekHistogramStruct *>(val.ptr);
+    StringVal result;
+    if (epiweek_histogram_empty(ewh)) {
+        result = StringVal::null();
+    } else {
+        std::string buffer;
+        const int32_t upper = epiweek_histogram_upper(val);
+        for (int32_t i = ewh->lower; i <= upper; i++) {
+            const uint64_t count = epiweek_histogram_count(ewh, i);
+            if (count == 0) {
+                continue;
+            }
+            if (!buffer.empty()) {
+                buffer += ", ";
+            }
+            const int yyyyww = (ewh->first_year + i / ewh->WEEKS) * 100 + i % ewh->WEEKS + 1;
+            buffer += std::to_string(yyyyww) + ":" + std::to_string(count);
+        }
+        if (ewh->other > 0) {
+            buffer += (buffer.empty() ? "other:" : ", other:") + std::to_string(ewh->other);
+        }
+        result = to_StringVal(context, buffer);
+    }
+
+    context->Free(val.ptr);
+    return result;
+}
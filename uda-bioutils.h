@@ -52,4 +52,30 @@ void CalcCDEntropyUpdate(FunctionContext *context, const StringVal &input, Strin
 void CalcCDEntropyMerge(FunctionContext *context, const StringVal &src, StringVal *dst);
 StringVal CalcCDEntropySerialize(FunctionContext *context, const StringVal &val);
 DoubleVal CalcCDEntropyFinalize(FunctionContext *context, const StringVal &val);
+
+// Pairwise Nucleotide Distance Functions
+void PairwiseSeqInit(FunctionContext *context, StringVal *val);
+void PairwiseSeqUpdate(
+    FunctionContext *context, const StringVal &id, const StringVal &seq, StringVal *val
+);
+void PairwiseSeqMerge(FunctionContext *context, const StringVal &src, StringVal *dst);
+StringVal PairwiseSeqSerialize(FunctionContext *context, const StringVal &val);
+StringVal PairwiseNtNearestFinalize(FunctionContext *context, const StringVal &val);
+StringVal PairwiseNtMatrixFinalize(FunctionContext *context, const StringVal &val);
+
+// MinHash Sketch Union
+void SketchUnionInit(FunctionContext *context, StringVal *val);
+void SketchUnionUpdateMerge(FunctionContext *context, const StringVal &src, StringVal *dst);
+StringVal SketchUnionSerialize(FunctionContext *context, const StringVal &val);
+StringVal SketchUnionFinalize(FunctionContext *context, const StringVal &val);
+
+// Epi Week Histogram
+void EpiWeekHistogramInit(FunctionContext *context, StringVal *val);
+void EpiWeekHistogramUpdate(FunctionContext *context, const DateVal &date, StringVal *val);
+void EpiWeekHistogramUpdate(
+    FunctionContext *context, const DateVal &date, const IntVal &first_year, StringVal *val
+);
+void EpiWeekHistogramMerge(FunctionContext *context, const StringVal &src, StringVal *dst);
+StringVal EpiWeekHistogramSerialize(FunctionContext *context, const StringVal &val);
+StringVal EpiWeekHistogramFinalize(FunctionContext *context, const StringVal &val);
 #endif
@@ -1,11 +1,14 @@
 // Samuel S. Shepard, CDC
 
+#include <fstream>
 #include <iostream>
 
+#include "boost/date_time/gregorian/gregorian.hpp"
 #include "udf-bioutils.h"
 #include <impala_udf/udf-test-harness.h>
 #include <tuple>
 #include <random>
+#include <sstream>
 
 using namespace impala;
 using namespace impala_udf;
@@ -14,18 +17,36 @@ using namespace std;
 bool test__any_instr() {
     int passing = true;
 
-    std::tuple<StringVal, StringVal, BooleanVal> table[7] = {
+    // Sequences long enough to be searched a vector at a time, with the ambiguity code in the
+    // first 64-byte step, the following 32-byte step and the byte-wise tail
+    std::string acgt(100, 'A');
+    for (int i = 0; i < 100; i++) {
+        acgt[i] = "ACGT"[i % 4];
+    }
+    std::string early = acgt, middle = acgt, tail = acgt;
+    early[10]         = 'N';
+    middle[70]        = 'R';
+    tail[99]          = 'y';
+    std::string accented = acgt + "\xC3\xA9";
+
+    std::tuple<StringVal, StringVal, BooleanVal> table[14] = {
         std::make_tuple("ABCDEFG", "abcxyz", false),
         std::make_tuple("ABCDEFG", "abcCxyz", true),
         std::make_tuple("", "abcCxyz", false),
         std::make_tuple("ABCDEFG", "", false),
         std::make_tuple("", "", true),
         std::make_tuple(StringVal::null(), "abcCxyz", BooleanVal::null()),
-        std::make_tuple("ABCDEFG", StringVal::null(), BooleanVal::null())
+        std::make_tuple("ABCDEFG", StringVal::null(), BooleanVal::null()),
+        std::make_tuple(acgt.c_str(), "RYKMSWBDHVNrykmswbdhvn", false),
+        std::make_tuple(early.c_str(), "RYKMSWBDHVNrykmswbdhvn", true),
+        std::make_tuple(middle.c_str(), "RYKMSWBDHVNrykmswbdhvn", true),
+        std::make_tuple(tail.c_str(), "RYKMSWBDHVNrykmswbdhvn", true),
+        std::make_tuple(acgt.c_str(), "\xC3\xA9\x80\xFF", false),
+        std::make_tuple(accented.c_str(), "\xA9", true),
+        std::make_tuple(accented.c_str(), "\xC2\x29", false)
     };
 
-
-    for (int i = 0; i < 7; i++) {
+    for (int i = 0; i < 14; i++) {
         auto [haystack, needles, expected] = table[i];
         if (!UdfTestHarness::ValidateUdf<BooleanVal, StringVal, StringVal>(
                 Find_Set_In_String, haystack, needles, expected
@@ -34,6 +55,42 @@ bool test__any_instr() {
                  << "|\n\t|" << expected.val << "|\n";
             passing = false;
         }
+
+        // Needles compiled once as a constant argument
+        std::vector<AnyVal *> constant_args = {NULL, &needles};
+        if (!UdfTestHarness::ValidateUdf<BooleanVal, StringVal, StringVal>(
+                Find_Set_In_String, haystack, needles, expected, Find_Set_Prepare, Find_Set_Close,
+                constant_args
+            )) {
+            cout << "UDX any_instr(S,const S)->B failed:\n\t|" << haystack.ptr << "|\n\t|"
+                 << needles.ptr << "|\n\t|" << expected.val << "|\n";
+            passing = false;
+        }
+    }
+
+    // Random bytes of every value against a plain search
+    std::mt19937 rng(42);
+    for (int i = 0; i < 500; i++) {
+        std::string haystack(rng() % 200 + 1, ' ');
+        std::string needles(rng() % 4 + 1, ' ');
+        for (auto &c : haystack) {
+            c = 1 + rng() % 255;
+        }
+        for (auto &c : needles) {
+            c = 1 + rng() % 255;
+        }
+        StringVal haystackVal(haystack.c_str());
+        StringVal needlesVal(needles.c_str());
+        BooleanVal expected(haystack.find_first_of(needles) != std::string::npos);
+
+        std::vector<AnyVal *> constant_args = {NULL, &needlesVal};
+        if (!UdfTestHarness::ValidateUdf<BooleanVal, StringVal, StringVal>(
+                Find_Set_In_String, haystackVal, needlesVal, expected, Find_Set_Prepare,
+                Find_Set_Close, constant_args
+            )) {
+            cout << "UDX any_instr Fuzz failed:\n\t|" << haystack << "|\n\t|" << needles << "|\n";
+            passing = false;
+        }
     }
 
     return passing;
@@ -43,7 +100,7 @@ bool test__any_instr() {
 bool test__complete_date() {
     int passing = true;
 
-    std::tuple<StringVal, StringVal> table[11] = {
+    std::tuple<StringVal, StringVal> table[13] = {
         std::make_tuple("2019", "2019-01-01"),
         std::make_tuple("2019-03", "2019-03-01"),
         std::make_tuple("2019-03-15", "2019-03-15"),
@@ -54,9 +111,11 @@ bool test__complete_date() {
         std::make_tuple("1981.09.12", "1981-09-12"),
         std::make_tuple("2000/01", "2000-01-01"),
         std::make_tuple("1", StringVal::null()),
-        std::make_tuple("0000-01-01", "0000-01-01")
+        std::make_tuple("0000-01-01", "0000-01-01"),
+        std::make_tuple("190315", "2019-03-15"),
+        std::make_tuple("2019-03-15-extra", "2019-03-15")
     };
-    for (int i = 0; i < 11; i++) {
+    for (int i = 0; i < 13; i++) {
         auto [arg0_s, expected] = table[i];
 
         if (!UdfTestHarness::ValidateUdf<StringVal, StringVal>(
@@ -79,7 +138,7 @@ DateVal to_dv(int yr, int mon, int day) {
 bool test__ending_in_saturday_str() {
     int passing = true;
 
-    std::tuple<StringVal, DateVal> table[11] = {
+    std::tuple<StringVal, DateVal> table[15] = {
         std::make_tuple("2019", DateVal::null()),
         std::make_tuple("2019-03", DateVal::null()),
         std::make_tuple("2019-03-15", to_dv(2019, 3, 16)),
@@ -90,9 +149,13 @@ bool test__ending_in_saturday_str() {
         std::make_tuple("1981.09.12", to_dv(1981, 9, 12)),
         std::make_tuple("2000/01/01", to_dv(2000, 1, 1)),
         std::make_tuple("1", DateVal::null()),
-        std::make_tuple("0000-01-01", DateVal::null())
+        std::make_tuple("0000-01-01", DateVal::null()),
+        std::make_tuple("2019-03-15 12:00:00", to_dv(2019, 3, 16)),
+        std::make_tuple(" 2019/ 3/+15", to_dv(2019, 3, 16)),
+        std::make_tuple("2019-02-29", DateVal::null()),
+        std::make_tuple("71555-03-15", DateVal::null())
     };
-    for (int i = 0; i < 11; i++) {
+    for (int i = 0; i < 15; i++) {
         auto [arg0_s, expected] = table[i];
 
         if (!UdfTestHarness::ValidateUdf<DateVal, StringVal>(
@@ -102,6 +165,15 @@ bool test__ending_in_saturday_str() {
                  << expected.val << "|\n";
             passing = false;
         }
+
+        // Repeated strings are served from the date parse cache
+        if (!UdfTestHarness::ValidateUdf<DateVal, StringVal>(
+                Date_Ending_In_Saturday_STR, arg0_s, expected, Date_Parse_Prepare, Date_Parse_Close
+            )) {
+            cout << "UDX ending_in_saturday(s) cached failed:\n\t|" << arg0_s.ptr << "|\n\t|"
+                 << expected.val << "|\n";
+            passing = false;
+        }
     }
 
     return passing;
@@ -137,6 +209,38 @@ bool test__ending_in_fornight_str() {
                  << arg1_b.val << "|\n\t|" << expected.val << "|\n";
             passing = false;
         }
+
+        if (!UdfTestHarness::ValidateUdf<DateVal, StringVal, BooleanVal>(
+                Fortnight_Date_Either_STR, arg0_s, arg1_b, expected, Date_Parse_Prepare,
+                Date_Parse_Close
+            )) {
+            cout << "UDX fortnight_date(s,b) cached failed:\n\t|" << arg0_s.ptr << "|\n\t|"
+                 << arg1_b.val << "|\n\t|" << expected.val << "|\n";
+            passing = false;
+        }
+    }
+
+    // Days outside 1400-9999 are NULL for the DATE and TIMESTAMP overloads as well
+    std::tuple<DateVal, DateVal> range_table[4] = {
+        std::make_tuple(DateVal(to_dv(1400, 1, 1).val - 1), DateVal::null()),
+        std::make_tuple(to_dv(2024, 4, 15), to_dv(2024, 4, 20)),
+        std::make_tuple(DateVal(to_dv(9999, 12, 31).val + 1), DateVal::null()),
+        std::make_tuple(DateVal(INT32_MIN / 2), DateVal::null())
+    };
+    for (int i = 0; i < 4; i++) {
+        auto [date, expected] = range_table[i];
+        TimestampVal ts(date.val + EPOCH_OFFSET, 0);
+
+        if (!UdfTestHarness::ValidateUdf<DateVal, DateVal, BooleanVal>(
+                Fortnight_Date_Either, date, BooleanVal(false), expected
+            ) ||
+            !UdfTestHarness::ValidateUdf<DateVal, TimestampVal, BooleanVal>(
+                Fortnight_Date_Either_TS, ts, BooleanVal(false), expected
+            )) {
+            cout << "UDX fortnight_date(d,b) range failed:\n\t|" << date.val << "|\n\t|"
+                 << expected.val << "|\n";
+            passing = false;
+        }
     }
 
     return passing;
@@ -171,20 +275,186 @@ bool test__ending_in_saturday_date() {
     return passing;
 }
 
+bool test__period_ending_date() {
+    int passing = true;
+
+    // Periods longer than the range of valid dates are rejected
+    const int32_t span = to_dv(9999, 12, 31).val - to_dv(1400, 1, 1).val;
+
+    std::tuple<DateVal, IntVal, DateVal, DateVal> table[13] = {
+        std::make_tuple(to_dv(2024, 2, 10), 28, to_dv(2024, 1, 27), to_dv(2024, 2, 24)),
+        std::make_tuple(to_dv(2024, 1, 27), 28, to_dv(2024, 1, 27), to_dv(2024, 1, 27)),
+        std::make_tuple(to_dv(2024, 1, 1), 28, to_dv(2024, 1, 27), to_dv(2024, 1, 27)),
+        std::make_tuple(to_dv(2023, 12, 30), 28, to_dv(2024, 1, 27), to_dv(2023, 12, 30)),
+        std::make_tuple(to_dv(2024, 4, 1), 91, to_dv(2024, 3, 30), to_dv(2024, 6, 29)),
+        std::make_tuple(to_dv(2024, 4, 1), 0, to_dv(2024, 3, 30), DateVal::null()),
+        std::make_tuple(to_dv(2024, 4, 1), -7, to_dv(2024, 3, 30), DateVal::null()),
+        std::make_tuple(to_dv(2024, 4, 1), IntVal::null(), to_dv(2024, 3, 30), DateVal::null()),
+        std::make_tuple(to_dv(2024, 4, 1), 28, DateVal::null(), DateVal::null()),
+        std::make_tuple(DateVal::null(), 28, to_dv(2024, 1, 27), DateVal::null()),
+        std::make_tuple(to_dv(2024, 1, 1), span, to_dv(2024, 1, 27), to_dv(2024, 1, 27)),
+        std::make_tuple(to_dv(2024, 1, 1), span + 1, to_dv(2024, 1, 27), DateVal::null()),
+        std::make_tuple(to_dv(2024, 1, 1), INT32_MAX, to_dv(2024, 1, 27), DateVal::null())
+    };
+    for (int i = 0; i < 13; i++) {
+        auto [arg0_d, arg1_i, arg2_d, expected] = table[i];
+
+        if (!UdfTestHarness::ValidateUdf<DateVal, DateVal, IntVal, DateVal>(
+                Period_Ending_Date, arg0_d, arg1_i, arg2_d, expected
+            )) {
+            cout << "UDX period_ending_date(d,i,d)->d failed:\n\t|" << arg0_d.val << "|\n\t|"
+                 << arg1_i.val << "|\n\t|" << arg2_d.val << "|\n\t|" << expected.val << "|\n";
+            passing = false;
+        }
+
+        // Period and anchor prepared once as constant arguments
+        std::vector<AnyVal *> constant_args = {NULL, &arg1_i, &arg2_d};
+        if (!UdfTestHarness::ValidateUdf<DateVal, DateVal, IntVal, DateVal>(
+                Period_Ending_Date, arg0_d, arg1_i, arg2_d, expected, Period_Ending_Prepare,
+                Period_Ending_Close, constant_args
+            )) {
+            cout << "UDX period_ending_date(d,const i,const d)->d failed:\n\t|" << arg0_d.val
+                 << "|\n\t|" << arg1_i.val << "|\n\t|" << arg2_d.val << "|\n\t|" << expected.val
+                 << "|\n";
+            passing = false;
+        }
+
+        TimestampVal ts = arg0_d.is_null ? TimestampVal::null()
+                                         : TimestampVal(arg0_d.val + EPOCH_OFFSET, 0);
+        if (!UdfTestHarness::ValidateUdf<DateVal, TimestampVal, IntVal, DateVal>(
+                Period_Ending_Date_TS, ts, arg1_i, arg2_d, expected
+            )) {
+            cout << "UDX period_ending_date(ts,i,d)->d failed:\n\t|" << arg0_d.val << "|\n\t|"
+                 << arg1_i.val << "|\n\t|" << arg2_d.val << "|\n\t|" << expected.val << "|\n";
+            passing = false;
+        }
+    }
+
+    std::tuple<StringVal, DateVal> str_table[4] = {
+        std::make_tuple("2024-02-10", to_dv(2024, 2, 24)),
+        std::make_tuple("2024/1/1", to_dv(2024, 1, 27)),
+        std::make_tuple("2024-02-30", DateVal::null()),
+        std::make_tuple("", DateVal::null())
+    };
+    for (int i = 0; i < 4; i++) {
+        auto [arg0_s, expected] = str_table[i];
+
+        if (!UdfTestHarness::ValidateUdf<DateVal, StringVal, IntVal, DateVal>(
+                Period_Ending_Date_STR, arg0_s, IntVal(28), to_dv(2024, 1, 27), expected
+            )) {
+            cout << "UDX period_ending_date(s,i,d)->d failed:\n\t|" << arg0_s.ptr << "|\n\t|"
+                 << expected.val << "|\n";
+            passing = false;
+        }
+    }
+
+    // Two-week periods anchored on a fortnight end agree with fortnight_date for either cadence
+    for (int32_t day = to_dv(1999, 12, 1).val; day < to_dv(2000, 3, 1).val; day++) {
+        for (bool legacy : {true, false}) {
+            DateVal anchor   = legacy ? to_dv(2024, 4, 27) : to_dv(2024, 4, 20);
+            DateVal expected = Fortnight_Date_Either(NULL, DateVal(day), BooleanVal(legacy));
+            if (!UdfTestHarness::ValidateUdf<DateVal, DateVal, IntVal, DateVal>(
+                    Period_Ending_Date, DateVal(day), IntVal(14), anchor, expected
+                )) {
+                cout << "UDX period_ending_date(d,14,d)->d failed:\n\t|" << day << "|\n\t|"
+                     << legacy << "|\n\t|" << expected.val << "|\n";
+                passing = false;
+            }
+        }
+    }
+
+    return passing;
+}
+
+bool test__epi_week() {
+    int passing = true;
+
+    // Year boundaries and dates on either side of the lookup table (1900 to 2100)
+    std::tuple<StringVal, IntVal> table[11] = {
+        std::make_tuple("2024-12-29", 202501),
+        std::make_tuple("2021-01-01", 202053),
+        std::make_tuple("2023/1/1", 202301),
+        std::make_tuple("2020.12.31", 202053),
+        std::make_tuple("2025-07-04", 202527),
+        std::make_tuple("1900-01-01", 190001),
+        std::make_tuple("2100-12-31", 210052),
+        std::make_tuple("1850-01-02", 185001),
+        std::make_tuple("2200-12-31", 220053),
+        std::make_tuple("2019-02-30", IntVal::null()),
+        std::make_tuple("2019-03", IntVal::null())
+    };
+    for (int i = 0; i < 11; i++) {
+        auto [arg0_s, expected] = table[i];
+
+        if (!UdfTestHarness::ValidateUdf<IntVal, StringVal, BooleanVal>(
+                Convert_String_To_EPI_Week, arg0_s, BooleanVal(true), expected
+            )) {
+            cout << "UDX to_epiweek(s, true)->i failed:\n\t|" << arg0_s.ptr << "|\n\t|"
+                 << expected.val << "|\n";
+            passing = false;
+        }
+
+        if (!UdfTestHarness::ValidateUdf<IntVal, StringVal, BooleanVal>(
+                Convert_String_To_EPI_Week, arg0_s, BooleanVal(true), expected,
+                Date_Parse_Prepare, Date_Parse_Close
+            )) {
+            cout << "UDX to_epiweek(s, true) cached failed:\n\t|" << arg0_s.ptr << "|\n\t|"
+                 << expected.val << "|\n";
+            passing = false;
+        }
+
+        IntVal week = expected.is_null ? IntVal::null() : IntVal(expected.val % 100);
+        if (!UdfTestHarness::ValidateUdf<IntVal, StringVal>(
+                Convert_String_To_EPI_Week, arg0_s, week
+            )) {
+            cout << "UDX to_epiweek(s)->i failed:\n\t|" << arg0_s.ptr << "|\n\t|" << week.val
+                 << "|\n";
+            passing = false;
+        }
+    }
+
+    std::tuple<DateVal, IntVal> ts_table[5] = {
+        std::make_tuple(to_dv(2024, 12, 29), 202501),
+        std::make_tuple(to_dv(1850, 1, 2), 185001),
+        std::make_tuple(to_dv(2200, 12, 31), 220053),
+        std::make_tuple(DateVal(to_dv(1400, 1, 1).val - 1), IntVal::null()),
+        std::make_tuple(DateVal(to_dv(9999, 12, 31).val + 1), IntVal::null())
+    };
+    for (int i = 0; i < 5; i++) {
+        auto [date, expected] = ts_table[i];
+        TimestampVal ts(date.val + EPOCH_OFFSET, 0);
+
+        if (!UdfTestHarness::ValidateUdf<IntVal, TimestampVal, BooleanVal>(
+                Convert_Timestamp_To_EPI_Week, ts, BooleanVal(true), expected
+            )) {
+            cout << "UDX to_epiweek(ts, true)->i failed:\n\t|" << date.val << "|\n\t|"
+                 << expected.val << "|\n";
+            passing = false;
+        }
+    }
+
+    return passing;
+}
+
 bool test__date_to_double() {
     bool passing = true;
 
-    std::tuple<DateVal, DoubleVal> table[7] = {
+    std::tuple<DateVal, DoubleVal> table[12] = {
         std::make_tuple(to_dv(2000, 1, 1), 2000.003),
+        std::make_tuple(to_dv(1400, 1, 1), 1400.003), // first year of the table
+        std::make_tuple(to_dv(9999, 12, 31), 9999.999), // last day of the table
+        std::make_tuple(to_dv(1600, 3, 1), 1600.167), // leap century
         std::make_tuple(to_dv(2000, 1, 17), 2000.046),
         std::make_tuple(to_dv(2001, 1, 17), 2001.047), // no leap day
         std::make_tuple(to_dv(2100, 1, 17), 2100.047), // no leap day
         std::make_tuple(to_dv(2000, 12, 31), 2000.999),
         std::make_tuple(to_dv(2001, 12, 31), 2001.999),
         std::make_tuple(to_dv(2025, 6, 16), 2025.458),
+        std::make_tuple(DateVal(-300000), DoubleVal::null()), // before 1400
+        std::make_tuple(DateVal::null(), DoubleVal::null()),
     };
 
-    for (int i = 0; i < 7; i++) {
+    for (int i = 0; i < 12; i++) {
         auto [arg0_s, expected] = table[i];
         if (!UdfTestHarness::ValidateUdf<DoubleVal, DateVal>(
             Date_to_Double, arg0_s, expected
@@ -200,17 +470,23 @@ bool test__date_to_double() {
 bool test__double_to_date() {
     bool passing = true;
 
-    std::tuple<DoubleVal, DateVal> table[7] = {
+    std::tuple<DoubleVal, DateVal> table[13] = {
         std::make_tuple(2000.003, to_dv(2000, 1, 1)),
+        std::make_tuple(1400.003, to_dv(1400, 1, 1)), // first year of the table
+        std::make_tuple(9999.999, to_dv(9999, 12, 31)), // last day of the table
+        std::make_tuple(1600.167, to_dv(1600, 3, 1)), // leap century
         std::make_tuple(2000.046, to_dv(2000, 1, 17)),
         std::make_tuple(2001.047, to_dv(2001, 1, 17)), // no leap day
         std::make_tuple(2100.047, to_dv(2100, 1, 17)), // no leap day
         std::make_tuple(2000.999, to_dv(2000, 12, 31)),
         std::make_tuple(2001.999, to_dv(2001, 12, 31)),
         std::make_tuple(2025.458, to_dv(2025, 6, 16)),
+        std::make_tuple(1399.5, DateVal::null()),
+        std::make_tuple(10000.0, DateVal::null()),
+        std::make_tuple(std::nan(""), DateVal::null()),
     };
 
-    for (int i = 0; i < 7; i++) {
+    for (int i = 0; i < 13; i++) {
         auto [arg0_s, expected] = table[i];
         if (!UdfTestHarness::ValidateUdf<DateVal, DoubleVal>(
             Double_to_Date, arg0_s, expected
@@ -251,7 +527,7 @@ bool test__doubleday_fuzz() {
 bool test__contains_element() {
     int passing = true;
 
-    std::tuple<StringVal, StringVal, StringVal, BooleanVal> table[12] = {
+    std::tuple<StringVal, StringVal, StringVal, BooleanVal> table[15] = {
         std::make_tuple("baby whales", "BABY;WHALES;FISH", ";", false),
         std::make_tuple("baby whales", "baby;whales;fish", ";", true),
         std::make_tuple(StringVal::null(), "whales;baby", ";", BooleanVal::null()),
@@ -263,10 +539,13 @@ bool test__contains_element() {
         std::make_tuple("baby whales", "xyz", "", true),
         std::make_tuple("baby whales", "xYz", "", false),
         std::make_tuple("300028908", "28907::28906::28905", "::", false),
-        std::make_tuple("300028908", "28908::28907::28906::28905", "::", true)
+        std::make_tuple("300028908", "28908::28907::28906::28905", "::", true),
+        std::make_tuple("baby whales", ";;fish;;whales;", ";", true),
+        std::make_tuple("baby whales", ";;;", ";", false),
+        std::make_tuple("baby whales", "fish:::whales", "::", false)
     };
 
-    for (int i = 0; i < 12; i++) {
+    for (int i = 0; i < 15; i++) {
         auto [needle, list, delim, expected] = table[i];
         if (!UdfTestHarness::ValidateUdf<BooleanVal, StringVal, StringVal, StringVal>(
                 Contains_An_Element, needle, list, delim, expected
@@ -275,6 +554,80 @@ bool test__contains_element() {
                  << list.ptr << "|\n\t|" << delim.ptr << "|\n\t|" << expected.val << "|\n";
             passing = false;
         }
+
+        // List and delimiter compiled once as constant arguments
+        std::vector<AnyVal *> constant_args = {NULL, &list, &delim};
+        if (!UdfTestHarness::ValidateUdf<BooleanVal, StringVal, StringVal, StringVal>(
+                Contains_An_Element, needle, list, delim, expected, Contains_Element_Prepare,
+                Contains_Element_Close, constant_args
+            )) {
+            cout << "UDX contains_element(S,const S,const S)->B failed:\n\t|" << needle.ptr
+                 << "|\n\t|" << list.ptr << "|\n\t|" << delim.ptr << "|\n\t|" << expected.val
+                 << "|\n";
+            passing = false;
+        }
+    }
+
+    return passing;
+}
+
+// compares the automaton built for a constant list against searching for each element in turn
+bool test__contains_element_fuzz() {
+    bool passing = true;
+
+    std::tuple<StringVal, StringVal, StringVal, BooleanVal> table[6] = {
+        std::make_tuple("ushers", "he;she;his;hers", ";", true),
+        std::make_tuple("uhsr", "he;she;his;hers", ";", false),
+        std::make_tuple("xxhix", "he;she;his;hers", ";", false),
+        std::make_tuple("ahishe", "hers::his", "::", true),
+        std::make_tuple("B.1.1.529", "BA.2;B.1.1.7;B.1.1.5", ";", true),
+        std::make_tuple("B.1.1.52", "BA.2;B.1.1.7;B.1.1.529", ";", false)
+    };
+    for (int i = 0; i < 6; i++) {
+        auto [needle, list, delim, expected] = table[i];
+        std::vector<AnyVal *> constant_args  = {NULL, &list, &delim};
+        if (!UdfTestHarness::ValidateUdf<BooleanVal, StringVal, StringVal, StringVal>(
+                Contains_An_Element, needle, list, delim, expected, Contains_Element_Prepare,
+                Contains_Element_Close, constant_args
+            )) {
+            cout << "UDX contains_element(S,const S,const S)->B failed:\n\t|" << needle.ptr
+                 << "|\n\t|" << list.ptr << "|\n\t|" << delim.ptr << "|\n\t|" << expected.val
+                 << "|\n";
+            passing = false;
+        }
+    }
+
+    std::mt19937 rng(42);
+    auto random_string = [&](int max_length) {
+        std::string s(rng() % (max_length + 1), 'a');
+        for (auto &c : s) {
+            c = "abc;"[rng() % 4];
+        }
+        return s;
+    };
+    for (int i = 0; i < 500; i++) {
+        std::string haystack = random_string(20);
+        std::string items    = random_string(30);
+        StringVal needle(haystack.c_str());
+        StringVal list(items.c_str());
+        StringVal delim(";");
+
+        bool found = false;
+        std::stringstream ss(items);
+        for (std::string item; std::getline(ss, item, ';');) {
+            found |= !item.empty() && haystack.find(item) != std::string::npos;
+        }
+        BooleanVal expected = haystack.empty() || items.empty() ? false : found;
+
+        std::vector<AnyVal *> constant_args = {NULL, &list, &delim};
+        if (!UdfTestHarness::ValidateUdf<BooleanVal, StringVal, StringVal, StringVal>(
+                Contains_An_Element, needle, list, delim, expected, Contains_Element_Prepare,
+                Contains_Element_Close, constant_args
+            )) {
+            cout << "UDX contains_element Fuzz failed:\n\t|" << haystack << "|\n\t|" << items
+                 << "|\n";
+            passing = false;
+        }
     }
 
     return passing;
@@ -284,7 +637,10 @@ bool test__contains_element() {
 bool test__contains_sym() {
     int passing = true;
 
-    std::tuple<StringVal, StringVal, BooleanVal> table[9] = {
+    // Long enough for the vector filter, with matches of the first and last bytes that fail
+    std::string strain = "A/Texas/50/2012(H3N2)-like virus, A/Hong_Kong/4801/2014(H3N2)-like";
+
+    std::tuple<StringVal, StringVal, BooleanVal> table[16] = {
         std::make_tuple("sam", "samuel", true),
         std::make_tuple("samuel", "sam", true),
         std::make_tuple(StringVal::null(), "sam", BooleanVal::null()),
@@ -293,9 +649,16 @@ bool test__contains_sym() {
         std::make_tuple("sam", "", false),
         std::make_tuple("", "", true),
         std::make_tuple("sam", "sam", true),
-        std::make_tuple("SAM", "samuel", false)
+        std::make_tuple("SAM", "samuel", false),
+        std::make_tuple(strain.c_str(), "A/Hong_Kong/4801/2014(H3N2)", true),
+        std::make_tuple("A/Hong_Kong/4801/2014(H3N1)", strain.c_str(), false),
+        std::make_tuple(strain.c_str(), "A/HONG_KONG/4801/2014(H3N2)", false),
+        std::make_tuple(strain.c_str(), "like", true),
+        std::make_tuple(strain.c_str(), "e", true),
+        std::make_tuple(strain.c_str(), "(H3N2)-likes", false),
+        std::make_tuple("sams", "samuel", false)
     };
-    for (int i = 0; i < 9; i++) {
+    for (int i = 0; i < 16; i++) {
         auto [arg0_s, arg1_s, expected] = table[i];
 
         if (!UdfTestHarness::ValidateUdf<BooleanVal, StringVal, StringVal>(
@@ -310,6 +673,74 @@ bool test__contains_sym() {
     return passing;
 }
 
+bool test__contains_sym_ignore_case() {
+    int passing = true;
+
+    std::string strain = "A/Texas/50/2012(H3N2)-like virus, A/Hong_Kong/4801/2014(H3N2)-like";
+
+    std::tuple<StringVal, StringVal, BooleanVal> table[12] = {
+        std::make_tuple("SAM", "samuel", true),
+        std::make_tuple("samuel", "sAm", true),
+        std::make_tuple(StringVal::null(), "sam", BooleanVal::null()),
+        std::make_tuple("sam", StringVal::null(), BooleanVal::null()),
+        std::make_tuple("", "sam", false),
+        std::make_tuple("", "", true),
+        std::make_tuple("SAM", "sam", true),
+        std::make_tuple("sam[", "SAM{", false),
+        std::make_tuple(strain.c_str(), "A/HONG_KONG/4801/2014(h3n2)", true),
+        std::make_tuple("a/texas/50/2012", strain.c_str(), true),
+        std::make_tuple(strain.c_str(), "A/HONG_KONG/4801/2014(H3N1)", false),
+        std::make_tuple("\xC3\x89" "cole", "\xC3\xA9" "COLE", false)
+    };
+    for (int i = 0; i < 12; i++) {
+        auto [arg0_s, arg1_s, expected] = table[i];
+
+        if (!UdfTestHarness::ValidateUdf<BooleanVal, StringVal, StringVal>(
+                Contains_Symmetric_Ignore_Case, arg0_s, arg1_s, expected
+            )) {
+            cout << "UDX contains_sym_ignore_case(ss)->b failed:\n\t|" << arg0_s.ptr << "|\n\t|"
+                 << arg1_s.ptr << "|\n\t|" << expected.val << "|\n";
+            passing = false;
+        }
+    }
+
+    // Random strings over a few letters of both cases against folding both sides
+    std::mt19937 rng(42);
+    for (int i = 0; i < 500; i++) {
+        std::string haystack(rng() % 100, ' ');
+        std::string needle(rng() % 4 + 1, ' ');
+        for (auto &c : haystack) {
+            c = "abAB["[rng() % 5];
+        }
+        for (auto &c : needle) {
+            c = "abAB{"[rng() % 5];
+        }
+        std::string folded_haystack = haystack, folded_needle = needle;
+        for (auto &c : folded_haystack) {
+            c = tolower(c);
+        }
+        for (auto &c : folded_needle) {
+            c = tolower(c);
+        }
+        BooleanVal expected(
+            !haystack.empty() && (folded_haystack.find(folded_needle) != std::string::npos ||
+                                  folded_needle.find(folded_haystack) != std::string::npos)
+        );
+
+        StringVal haystackVal(haystack.c_str());
+        StringVal needleVal(needle.c_str());
+        if (!UdfTestHarness::ValidateUdf<BooleanVal, StringVal, StringVal>(
+                Contains_Symmetric_Ignore_Case, needleVal, haystackVal, expected
+            )) {
+            cout << "UDX contains_sym_ignore_case Fuzz failed:\n\t|" << haystack << "|\n\t|"
+                 << needle << "|\n";
+            passing = false;
+        }
+    }
+
+    return passing;
+}
+
 bool test__cut_paste() {
     int passing = true;
 
@@ -354,7 +785,7 @@ bool test__cut_paste() {
 bool test__cut_paste_out() {
     int passing = true;
 
-    std::tuple<StringVal, StringVal, StringVal, StringVal, StringVal> table[16] = {
+    std::tuple<StringVal, StringVal, StringVal, StringVal, StringVal> table[23] = {
         std::make_tuple("Sam-The-Wham", "-", "1-2", "/", "Sam/The"),
         std::make_tuple("Sam-The-Wham", "-", "3-1", "/", "Wham/The/Sam"),
         std::make_tuple("Sam-The-Wham", "-", "3,2,1", "//", "Wham//The//Sam"),
@@ -375,10 +806,18 @@ bool test__cut_paste_out() {
             "The::fields::are::cut::pastable::!", "::", "1..3;6,6;4-3", " ",
             "The fields are ! ! cut are"
         ),
-        std::make_tuple("Sam-The-Wham", "-", "A-B;a,b,c", "/", StringVal::null())
+        std::make_tuple("Sam-The-Wham", "-", "A-B;a,b,c", "/", StringVal::null()),
+        // Only the fields up to the highest requested are split out
+        std::make_tuple("a|b|c|d|e|f|g|h", "|", "2", "/", "b"),
+        std::make_tuple("a|b|c|d|e|f|g|h", "|", "3-1", "/", "c/b/a"),
+        std::make_tuple("--Sam---The-Wham-", "-", "2,3", "/", "The/Wham"),
+        std::make_tuple("Sam-The-Wham", "-", "0,1,2-9,9", "/", "Sam"),
+        std::make_tuple("Sam-The-Wham", "-", "4-5", "/", ""),
+        std::make_tuple("Sam-The-Wham", "-", "0-1", "/", ""),
+        std::make_tuple("Sam-The-Wham", "-", "1,2;1-2-3", "/", StringVal::null())
     };
 
-    for (int i = 0; i < 16; i++) {
+    for (int i = 0; i < 23; i++) {
         auto [arg0_s, arg1_s, arg2_s, arg3_s, expected] = table[i];
 
         if (!UdfTestHarness::ValidateUdf<StringVal, StringVal, StringVal, StringVal, StringVal>(
@@ -389,6 +828,18 @@ bool test__cut_paste_out() {
                  << "|\n";
             passing = false;
         }
+
+        // Range map compiled once as a constant argument
+        std::vector<AnyVal *> constant_args = {NULL, NULL, &arg2_s, NULL};
+        if (!UdfTestHarness::ValidateUdf<StringVal, StringVal, StringVal, StringVal, StringVal>(
+                Cut_Paste_Output, arg0_s, arg1_s, arg2_s, arg3_s, expected, Cut_Paste_Prepare,
+                Cut_Paste_Close, constant_args
+            )) {
+            cout << "UDX cut_paste(ss,const s,s)->s failed:\n\t|" << arg0_s.ptr << "|\n\t|"
+                 << arg1_s.ptr << "|\n\t|" << arg2_s.ptr << "|\n\t|" << arg3_s.ptr << "|\n\t|"
+                 << expected.ptr << "|\n";
+            passing = false;
+        }
     }
 
     return passing;
@@ -483,7 +934,7 @@ bool test__hamming_distance_pds() {
 bool test__is_element() {
     int passing = true;
 
-    std::tuple<StringVal, StringVal, StringVal, BooleanVal> table[14] = {
+    std::tuple<StringVal, StringVal, StringVal, BooleanVal> table[17] = {
         std::make_tuple("whales", "BABY;WHALES;FISH", ";", false),
         std::make_tuple("whales", "baby;whales;fish", ";", true),
         std::make_tuple("baby whales", "baby;whales;fish", ";", false),
@@ -497,10 +948,13 @@ bool test__is_element() {
         std::make_tuple("y", "xYz", "", false),
         std::make_tuple("300028908", "28907::28906::28905", "::", false),
         std::make_tuple("300028908", "28908::28907::28906::28905", "::", false),
-        std::make_tuple("300028908", "300028908::300028907::300028906::300028905", "::", true)
+        std::make_tuple("300028908", "300028908::300028907::300028906::300028905", "::", true),
+        std::make_tuple("whales", "::fish::::whales::", "::", true),
+        std::make_tuple("", ";;", ";", false),
+        std::make_tuple(":whales", "fish:::whales", "::", true)
     };
 
-    for (int i = 0; i < 14; i++) {
+    for (int i = 0; i < 17; i++) {
         auto [mystring, list, delim, expected] = table[i];
         if (!UdfTestHarness::ValidateUdf<BooleanVal, StringVal, StringVal, StringVal>(
                 Is_An_Element, mystring, list, delim, expected
@@ -509,6 +963,64 @@ bool test__is_element() {
                  << "|\n\t|" << delim.ptr << "|\n\t|" << expected.val << "|\n";
             passing = false;
         }
+
+        // List and delimiter indexed once as constant arguments
+        std::vector<AnyVal *> constant_args = {NULL, &list, &delim};
+        if (!UdfTestHarness::ValidateUdf<BooleanVal, StringVal, StringVal, StringVal>(
+                Is_An_Element, mystring, list, delim, expected, Is_Element_Prepare,
+                Is_Element_Close, constant_args
+            )) {
+            cout << "UDX is_element(S,const S,const S)->B failed:\n\t|" << mystring.ptr
+                 << "|\n\t|" << list.ptr << "|\n\t|" << delim.ptr << "|\n\t|" << expected.val
+                 << "|\n";
+            passing = false;
+        }
+    }
+
+    return passing;
+}
+
+// a constant list of thousands of accessions, including duplicates, is indexed into a hash set
+bool test__is_element_set() {
+    bool passing = true;
+
+    std::string items;
+    for (int i = 0; i < 5000; i++) {
+        items += "EPI_ISL_" + std::to_string(100000 + 2 * i) + ",";
+    }
+    items += "EPI_ISL_100000,,EPI_ISL_1";
+    StringVal list(items.c_str());
+    StringVal delim(",");
+    std::vector<AnyVal *> constant_args = {NULL, &list, &delim};
+
+    for (int i = 0; i < 200; i++) {
+        std::string accession = "EPI_ISL_" + std::to_string(100000 + 49 * i);
+        StringVal needle(accession.c_str());
+        BooleanVal expected(i % 2 == 0);
+        if (!UdfTestHarness::ValidateUdf<BooleanVal, StringVal, StringVal, StringVal>(
+                Is_An_Element, needle, list, delim, expected, Is_Element_Prepare,
+                Is_Element_Close, constant_args
+            )) {
+            cout << "UDX is_element(S,const S,const S)->B failed:\n\t|" << accession << "|\n";
+            passing = false;
+        }
+    }
+
+    std::tuple<StringVal, BooleanVal> table[4] = {
+        std::make_tuple("EPI_ISL_1", true),
+        std::make_tuple("EPI_ISL_", false),
+        std::make_tuple("EPI_ISL_1000000", false),
+        std::make_tuple(StringVal::null(), BooleanVal::null())
+    };
+    for (int i = 0; i < 4; i++) {
+        auto [needle, expected] = table[i];
+        if (!UdfTestHarness::ValidateUdf<BooleanVal, StringVal, StringVal, StringVal>(
+                Is_An_Element, needle, list, delim, expected, Is_Element_Prepare,
+                Is_Element_Close, constant_args
+            )) {
+            cout << "UDX is_element(S,const S,const S)->B failed:\n\t|" << needle.ptr << "|\n";
+            passing = false;
+        }
     }
 
     return passing;
@@ -790,10 +1302,313 @@ bool test__nt_distance() {
     return passing;
 }
 
+bool test__nearest_reference() {
+    int passing = true;
+
+    const char *panel = "ref_a:ATGAGGCAG;ref_b:ATcAGGCrG;ref_c:TTTTTTTTT";
+    std::tuple<StringVal, StringVal, StringVal> table[7] = {
+        std::make_tuple("ATGAGGCAG", panel, "ref_a:0"),
+        std::make_tuple("ATcAGGCAG", panel, "ref_b:0"),
+        std::make_tuple("TTTAGGCAG", panel, "ref_a:2"),
+        std::make_tuple("TTTTTTTTTnnnnn", panel, "ref_c:0"),
+        std::make_tuple(StringVal::null(), panel, StringVal::null()),
+        std::make_tuple("ATGAGGCAG", "ref_a", StringVal::null()),
+        std::make_tuple("ATGAGGCAG", "/no/such/panel.fasta", StringVal::null())
+    };
+    for (int i = 0; i < 7; i++) {
+        auto [arg0_s, arg1_s, expected] = table[i];
+
+        // Per-row panel
+        if (!UdfTestHarness::ValidateUdf<StringVal, StringVal, StringVal>(
+                Nearest_Reference, arg0_s, arg1_s, expected
+            )) {
+            cout << "UDX nearest_reference(ss)->s failed:\n\t|" << arg0_s.ptr << "|\n\t|"
+                 << arg1_s.ptr << "|\n\t|" << expected.ptr << "|\n";
+            passing = false;
+        }
+
+        // Panel prepared once as a constant argument
+        std::vector<AnyVal *> constant_args = {NULL, &arg1_s};
+        if (!UdfTestHarness::ValidateUdf<StringVal, StringVal, StringVal>(
+                Nearest_Reference, arg0_s, arg1_s, expected, Nearest_Reference_Prepare,
+                Nearest_Reference_Close, constant_args
+            )) {
+            cout << "UDX nearest_reference(s,const s)->s failed:\n\t|" << arg0_s.ptr
+                 << "|\n\t|" << arg1_s.ptr << "|\n\t|" << expected.ptr << "|\n";
+            passing = false;
+        }
+    }
+
+    // A FASTA file is read only when the panel is a constant
+    const std::string fasta_path = "/tmp/udx-nearest-reference-test.fasta";
+    std::ofstream(fasta_path) << ">ref_a\nATGAG\nGCAG\n>ref_b \nTTTTTTTTT\n";
+    StringVal fasta_val(fasta_path.c_str());
+    std::vector<AnyVal *> constant_args = {NULL, &fasta_val};
+    if (!UdfTestHarness::ValidateUdf<StringVal, StringVal, StringVal>(
+            Nearest_Reference, StringVal("TTTATTTTT"), fasta_val, StringVal("ref_b:1"),
+            Nearest_Reference_Prepare, Nearest_Reference_Close, constant_args
+        ) ||
+        !UdfTestHarness::ValidateUdf<StringVal, StringVal, StringVal>(
+            Nearest_Reference, StringVal("TTTATTTTT"), fasta_val, StringVal::null()
+        )) {
+        cout << "UDX nearest_reference(s,fasta)->s failed:\n\t|" << fasta_path << "|\n";
+        passing = false;
+    }
+    std::remove(fasta_path.c_str());
+
+    return passing;
+}
+
+// Packed sequences contain null bytes, so they are built with explicit lengths
+const std::string PACKED4_ACGTN_ =
+    std::string("\x04\x06\x00\x00\x00\x00\x00\x00\x00\x21\x84\x0F", 12);
+const std::string PACKED4_ACRTN_ =
+    std::string("\x04\x06\x00\x00\x00\x01\x00\x00\x00\x21\x85\x0F\x05\x00\x00\x00.", 17);
+const std::string PACKED2_ACGTAC =
+    std::string("\x02\x06\x00\x00\x00\x00\x00\x00\x00\xE4\x04", 11);
+const std::string PACKED2_ACGTTN =
+    std::string("\x02\x06\x00\x00\x00\x01\x00\x00\x00\xE4\x03\x05\x00\x00\x00N", 16);
+// Malformed: an exception past the last site, and exceptions out of order
+const std::string PACKED2_PAST_END =
+    std::string("\x02\x06\x00\x00\x00\x01\x00\x00\x00\xE4\x03\x06\x00\x00\x00N", 16);
+const std::string PACKED2_UNSORTED = std::string(
+    "\x02\x06\x00\x00\x00\x02\x00\x00\x00\xE4\x03\x05\x00\x00\x00N\x04\x00\x00\x00N", 21
+);
+const std::string PACKED2_ATCG_G =
+    std::string("\x02\x0C\x00\x00\x00\x00\x00\x00\x00\x9C\x9C\x9C", 12);
+const std::string PACKED2_ATCG_A =
+    std::string("\x02\x0C\x00\x00\x00\x00\x00\x00\x00\x9C\x9C\x1C", 12);
+
+StringVal packed_val(const std::string &packed) {
+    return StringVal((uint8_t *)packed.data(), packed.size());
+}
+
+bool test__nt_pack() {
+    int passing = true;
+
+    std::tuple<StringVal, IntVal, StringVal> table[7] = {
+        std::make_tuple("ACGTN-", 4, packed_val(PACKED4_ACGTN_)),
+        std::make_tuple("acrtn.", 4, packed_val(PACKED4_ACRTN_)),
+        std::make_tuple("ACGTAC", 2, packed_val(PACKED2_ACGTAC)),
+        std::make_tuple("acgttn", 2, packed_val(PACKED2_ACGTTN)),
+        std::make_tuple("ACGT", 3, StringVal::null()),
+        std::make_tuple("", 4, StringVal::null()),
+        std::make_tuple(StringVal::null(), 2, StringVal::null())
+    };
+    for (int i = 0; i < 7; i++) {
+        auto [arg0_s, arg1_i, expected] = table[i];
+
+        if (!UdfTestHarness::ValidateUdf<StringVal, StringVal, IntVal>(
+                NT_Pack_Bits, arg0_s, arg1_i, expected
+            )) {
+            cout << "UDX nt_pack(si)->s failed:\n\t|" << arg0_s.ptr << "|\n\t|" << arg1_i.val
+                 << "|\n";
+            passing = false;
+        }
+    }
+
+    if (!UdfTestHarness::ValidateUdf<StringVal, StringVal>(
+            NT_Pack, StringVal("ACGTN-"), packed_val(PACKED4_ACGTN_)
+        )) {
+        cout << "UDX nt_pack(s)->s failed:\n\t|ACGTN-|\n";
+        passing = false;
+    }
+
+    return passing;
+}
+
+bool test__nt_unpack() {
+    int passing = true;
+
+    std::tuple<StringVal, StringVal> table[7] = {
+        std::make_tuple(packed_val(PACKED4_ACRTN_), "ACRTN."),
+        std::make_tuple(packed_val(PACKED2_ACGTTN), "ACGTTN"),
+        std::make_tuple(packed_val(PACKED2_ATCG_A), "ATCGATCGATCA"),
+        std::make_tuple(packed_val(PACKED2_PAST_END), StringVal::null()),
+        std::make_tuple(packed_val(PACKED2_UNSORTED), StringVal::null()),
+        std::make_tuple("ACGT", StringVal::null()),
+        std::make_tuple(StringVal::null(), StringVal::null())
+    };
+    for (int i = 0; i < 7; i++) {
+        auto [arg0_s, expected] = table[i];
+
+        if (!UdfTestHarness::ValidateUdf<StringVal, StringVal>(NT_Unpack, arg0_s, expected)) {
+            cout << "UDX nt_unpack(s)->s failed:\n\t|" << expected.ptr << "|\n";
+            passing = false;
+        }
+    }
+
+    return passing;
+}
+
+bool test__packed_distances() {
+    int passing = true;
+
+    // packed1, packed2, nt_distance, hamming_distance, tn_93
+    std::tuple<StringVal, StringVal, IntVal, IntVal, DoubleVal> table[6] = {
+        std::make_tuple(
+            packed_val(PACKED4_ACGTN_), packed_val(PACKED4_ACRTN_), 0, 1, DoubleVal::null()
+        ),
+        std::make_tuple(
+            packed_val(PACKED2_ACGTAC), packed_val(PACKED2_ACGTTN), 1, 2, 0.23992356680997826
+        ),
+        std::make_tuple(
+            packed_val(PACKED2_ATCG_G), packed_val(PACKED2_ATCG_A), 1, 1, 0.10204780968478636
+        ),
+        std::make_tuple(
+            packed_val(PACKED4_ACGTN_), packed_val(PACKED2_ACGTAC), IntVal::null(), IntVal::null(),
+            DoubleVal::null()
+        ),
+        std::make_tuple(
+            packed_val(PACKED4_ACGTN_), "ACGT", IntVal::null(), IntVal::null(), DoubleVal::null()
+        ),
+        std::make_tuple(
+            StringVal::null(), packed_val(PACKED2_ACGTAC), IntVal::null(), IntVal::null(),
+            DoubleVal::null()
+        )
+    };
+    for (int i = 0; i < 6; i++) {
+        auto [arg0_s, arg1_s, nt_expected, hd_expected, tn_expected] = table[i];
+
+        if (!UdfTestHarness::ValidateUdf<IntVal, StringVal, StringVal>(
+                Nt_Distance_Packed, arg0_s, arg1_s, nt_expected
+            )) {
+            cout << "UDX nt_distance_packed(ss)->i failed for case " << i << ":\n\t|"
+                 << nt_expected.val << "|\n";
+            passing = false;
+        }
+        if (!UdfTestHarness::ValidateUdf<IntVal, StringVal, StringVal>(
+                Hamming_Distance_Packed, arg0_s, arg1_s, hd_expected
+            )) {
+            cout << "UDX hamming_distance_packed(ss)->i failed for case " << i << ":\n\t|"
+                 << hd_expected.val << "|\n";
+            passing = false;
+        }
+        if (!UdfTestHarness::ValidateUdf<DoubleVal, StringVal, StringVal>(
+                Tn_93_Distance_Packed, arg0_s, arg1_s, tn_expected
+            )) {
+            cout << "UDX tn_93_packed(ss)->d failed for case " << i << ":\n\t|"
+                 << tn_expected.val << "|\n";
+            passing = false;
+        }
+    }
+
+    return passing;
+}
+
+bool test__align_to_reference() {
+    int passing = true;
+
+    // query, reference, band, aligned, insertions
+    std::tuple<StringVal, StringVal, IntVal, StringVal, StringVal> table[10] = {
+        std::make_tuple("ACGTCGTACGT", "ACGTACGTACGT", 64, "ACGT-CGTACGT", ""),
+        std::make_tuple("AAAACCCCATGGGGTTTT", "AAAACCCCGGGGTTTT", 0, "AAAACCCCGGGGTTTT", "8:AT"),
+        std::make_tuple("acgtacgaacgt", "ACGTACGTACGT", 2, "acgtacgaacgt", ""),
+        std::make_tuple("CCCCGGGG", "AAAACCCCGGGGTTTT", 1, "----CCCCGGGG----", ""),
+        std::make_tuple(
+            "AAAACCCCGGGGTTTTAAAACCCC", "AAAACCCCGGGGTTTT", 0, "AAAACCCCGGGGTTTT", "16:AAAACCCC"
+        ),
+        std::make_tuple("ACGT", "ACGT", -1, StringVal::null(), StringVal::null()),
+        std::make_tuple("", "ACGT", 8, StringVal::null(), StringVal::null()),
+        std::make_tuple(StringVal::null(), "ACGT", 8, StringVal::null(), StringVal::null()),
+        std::make_tuple(
+            "TAYGTCTACGATGAGTCTgCTGACTA", "AAGTGTGCTTTGGGGCCCGGCCTATGGCGATGATCTGACTA", 52,
+            "TA-YGT---------------CTA---CGATGAgCTGACTA", "33:GTCT"
+        ),
+        std::make_tuple(
+            "ACCGATAGTTAGTGTGCAACGGCAGGGAcACGTYTATCGGCRTCGAGACCRGATTCCCGCGAYCAGTGTCGACCCC-"
+            "TCGGGTATATACtACCCTCRGCCAGCC",
+            "CAGTTAGTGTCCGGCGACGTATCAAACGGGCATCGAGACAAATTCCCGCGCAACTGTGTCGAAATCGGGTATATACC"
+            "ACCCTCTGCCATGCC",
+            13,
+            "TAGTTAGTGTGCGGAcACGTATC-----GGCRTCGAGACRGATTCCCGCG-AYCAGTGTCGAC-TCGGGTATATACtA"
+            "CCCTCRGCCA-GCC",
+            "0:ACCGA, 12:AACGGCAG, 19:TY, 38:C, 62:CCC"
+        )
+    };
+    for (int i = 0; i < 10; i++) {
+        auto [arg0_s, arg1_s, arg2_i, aligned, insertions] = table[i];
+
+        if (!UdfTestHarness::ValidateUdf<StringVal, StringVal, StringVal, IntVal>(
+                Align_To_Reference_Band, arg0_s, arg1_s, arg2_i, aligned
+            )) {
+            cout << "UDX align_to_reference(ssi)->s failed for case " << i << "\n";
+            passing = false;
+        }
+        if (!UdfTestHarness::ValidateUdf<StringVal, StringVal, StringVal, IntVal>(
+                Alignment_Insertions_Band, arg0_s, arg1_s, arg2_i, insertions
+            )) {
+            cout << "UDX alignment_insertions(ssi)->s failed for case " << i << "\n";
+            passing = false;
+        }
+    }
+
+    if (!UdfTestHarness::ValidateUdf<StringVal, StringVal, StringVal>(
+            Align_To_Reference, "ACGTCGTACGT", "ACGTACGTACGT", "ACGT-CGTACGT"
+        )) {
+        cout << "UDX align_to_reference(ss)->s failed\n";
+        passing = false;
+    }
+
+    // Long enough for many vectors per row: substitutions stay on the diagonal, and a deletion and
+    // an insertion of 12 T between AC and GA can only be placed one way. Bands of 8 widths start
+    // the deletion at every lane of a vector.
+    std::mt19937 rng(42);
+    std::string reference(2000, ' ');
+    for (auto &c : reference) {
+        c = "ACGT"[rng() % 4];
+    }
+    const std::string run(12, 'T');
+    reference.replace(700, 16, "AC" + run + "GA");
+    reference.replace(1400, 4, "ACGA");
+
+    std::string substituted = reference;
+    for (std::size_t i = 0; i < substituted.size(); i += 25) {
+        substituted[i] = substituted[i] == 'A' ? 'C' : 'A';
+    }
+    std::string shifted = reference.substr(0, 702) + reference.substr(714, 688) + run +
+                          reference.substr(1402);
+    std::string deleted = reference;
+    deleted.replace(702, 12, std::string(12, '-'));
+
+    std::tuple<std::string, std::string, std::string> long_table[2] = {
+        std::make_tuple(substituted, substituted, ""),
+        std::make_tuple(shifted, deleted, "1402:" + run)
+    };
+    StringVal reference_val(reference.c_str());
+    for (int i = 0; i < 2; i++) {
+        auto &[query, aligned, insertions] = long_table[i];
+        StringVal query_val(query.c_str());
+
+        for (int band = 60; band < 68; band++) {
+            if (!UdfTestHarness::ValidateUdf<StringVal, StringVal, StringVal, IntVal>(
+                    Align_To_Reference_Band, query_val, reference_val, IntVal(band),
+                    StringVal(aligned.c_str())
+                ) ||
+                !UdfTestHarness::ValidateUdf<StringVal, StringVal, StringVal, IntVal>(
+                    Alignment_Insertions_Band, query_val, reference_val, IntVal(band),
+                    StringVal(insertions.c_str())
+                )) {
+                cout << "UDX align_to_reference(ssi)->s failed for long case " << i
+                     << " with band " << band << "\n";
+                passing = false;
+            }
+        }
+    }
+
+    return passing;
+}
+
 bool test__nt_id() {
     int passing = true;
 
-    std::tuple<StringVal, StringVal> table[8] = {
+    // Spans several hashing chunks with characters dropped throughout
+    std::string long_seq = "";
+    for (int i = 0; i < 5000; i++) {
+        long_seq += "a-";
+    }
+
+    std::tuple<StringVal, StringVal> table[9] = {
         std::make_tuple("", StringVal::null()),
         std::make_tuple(StringVal::null(), StringVal::null()),
         std::make_tuple(
@@ -813,9 +1628,10 @@ bool test__nt_id() {
             "6f8a94f328a6374ab9af217e0dd2ea85b00f176a"
         ),
         std::make_tuple("1", "356a192b7913b04c54574d18c28d46e6395428ab"),
-        std::make_tuple("TCC ACC GCC CGG AAA", "a3505a17b5b0adf08a7d43667e0802a05beedc8c")
+        std::make_tuple("TCC ACC GCC CGG AAA", "a3505a17b5b0adf08a7d43667e0802a05beedc8c"),
+        std::make_tuple(long_seq.c_str(), "33e2a1918af3a4127b5a02cbfa7703061b52dc28")
     };
-    for (int i = 0; i < 8; i++) {
+    for (int i = 0; i < 9; i++) {
         auto [arg0_s, expected] = table[i];
 
         if (!UdfTestHarness::ValidateUdf<StringVal, StringVal>(nt_id, arg0_s, expected)) {
@@ -823,6 +1639,253 @@ bool test__nt_id() {
                  << "|\n";
             passing = false;
         }
+
+        // Repeated calls are served from the memo cache
+        if (!UdfTestHarness::ValidateUdf<StringVal, StringVal>(
+                nt_id, arg0_s, expected, Memo_Prepare, Memo_Close
+            )) {
+            cout << "UDX nt_id_cached(s)->s failed:\n\t|" << arg0_s.ptr << "|\n\t|"
+                 << expected.ptr << "|\n";
+            passing = false;
+        }
+    }
+
+    return passing;
+}
+
+bool test__nt_std_aa_std() {
+    int passing = true;
+
+    // Long enough for whole blocks of letters and of mixed bytes
+    std::string long_seq = "", long_nt = "", long_aa = "";
+    for (int i = 0; i < 100; i++) {
+        long_seq += "acgtACGTacgtACGTacgtACGTacgtACGTacgtACGTacgtACGTacgtACGTacgtACGT.~-";
+        long_nt += "ACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGT";
+        long_aa += "ACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGT~";
+    }
+
+    // sequence, nt_std, aa_std
+    std::tuple<StringVal, StringVal, StringVal> table[7] = {
+        std::make_tuple("", StringVal::null(), StringVal::null()),
+        std::make_tuple(StringVal::null(), StringVal::null(), StringVal::null()),
+        std::make_tuple("atg aac\tACT\r\n", "ATGAACACT", "ATGAACACT"),
+        std::make_tuple("MNTQ...IL-V:F~", "MNTQILVF", "MNTQILVF~"),
+        std::make_tuple("---~~~", "", "~~~"),
+        std::make_tuple("n?*1x", "N?*1X", "N?*1X"),
+        std::make_tuple(long_seq.c_str(), long_nt.c_str(), long_aa.c_str())
+    };
+    for (int i = 0; i < 7; i++) {
+        auto [arg0_s, expected_nt, expected_aa] = table[i];
+
+        if (!UdfTestHarness::ValidateUdf<StringVal, StringVal>(nt_std, arg0_s, expected_nt)) {
+            cout << "UDX nt_std(s)->s failed:\n\t|" << arg0_s.ptr << "|\n\t|" << expected_nt.ptr
+                 << "|\n";
+            passing = false;
+        }
+        if (!UdfTestHarness::ValidateUdf<StringVal, StringVal>(aa_std, arg0_s, expected_aa)) {
+            cout << "UDX aa_std(s)->s failed:\n\t|" << arg0_s.ptr << "|\n\t|" << expected_aa.ptr
+                 << "|\n";
+            passing = false;
+        }
+    }
+
+    return passing;
+}
+
+bool test__fingerprint() {
+    int passing = true;
+
+    std::string long_seq = "";
+    for (int i = 0; i < 5000; i++) {
+        long_seq += "a-";
+    }
+
+    // sequence, nt_fingerprint, nt_fingerprint_hi, nt_fingerprint_lo, aa_fingerprint
+    std::tuple<StringVal, StringVal, BigIntVal, BigIntVal, StringVal> table[7] = {
+        std::make_tuple(
+            "ATGAACACTCAAATCCTGGTATTCGCTCTGGTGGCGAGCATTCCGACAAATGCA",
+            "54baf936ae171ac92477adba34075517", 6105466258098428617LL, 2627759922842391831LL,
+            "54baf936ae171ac92477adba34075517"
+        ),
+        std::make_tuple(
+            "atgaacactcaaatcctggtattcgctctggtggcgagcattccgacaaatgca...---~~~:::",
+            "54baf936ae171ac92477adba34075517", 6105466258098428617LL, 2627759922842391831LL,
+            "50073d165239c9251255bec55dcf9983"
+        ),
+        std::make_tuple(
+            "NRMANHSSELL~", "25b1275783bc9e95661d3facd8393f39", 2715995307106934421LL,
+            7358107377787813689LL, "5eaf2d7183ea4b942ffb77e963b0eea1"
+        ),
+        std::make_tuple(
+            long_seq.c_str(), "4cc6544a1ffc3ba939f85ac7f2de38e6", 5532201869612170153LL,
+            4177188469205776614LL, "4cc6544a1ffc3ba939f85ac7f2de38e6"
+        ),
+        std::make_tuple(
+            "A", "bdbe77ac0d3ced12f181eaa5aab1ee81", -4774246974125970158LL,
+            -1044295641318953343LL, "bdbe77ac0d3ced12f181eaa5aab1ee81"
+        ),
+        std::make_tuple(
+            "", StringVal::null(), BigIntVal::null(), BigIntVal::null(), StringVal::null()
+        ),
+        std::make_tuple(
+            StringVal::null(), StringVal::null(), BigIntVal::null(), BigIntVal::null(),
+            StringVal::null()
+        )
+    };
+    for (int i = 0; i < 7; i++) {
+        auto [arg0_s, nt_hex, nt_hi, nt_lo, aa_hex] = table[i];
+
+        if (!UdfTestHarness::ValidateUdf<StringVal, StringVal>(nt_fingerprint, arg0_s, nt_hex)) {
+            cout << "UDX nt_fingerprint(s)->s failed for case " << i << "\n";
+            passing = false;
+        }
+        if (!UdfTestHarness::ValidateUdf<BigIntVal, StringVal>(nt_fingerprint_hi, arg0_s, nt_hi)) {
+            cout << "UDX nt_fingerprint_hi(s)->l failed for case " << i << "\n";
+            passing = false;
+        }
+        if (!UdfTestHarness::ValidateUdf<BigIntVal, StringVal>(nt_fingerprint_lo, arg0_s, nt_lo)) {
+            cout << "UDX nt_fingerprint_lo(s)->l failed for case " << i << "\n";
+            passing = false;
+        }
+        if (!UdfTestHarness::ValidateUdf<StringVal, StringVal>(aa_fingerprint, arg0_s, aa_hex)) {
+            cout << "UDX aa_fingerprint(s)->s failed for case " << i << "\n";
+            passing = false;
+        }
+    }
+
+    return passing;
+}
+
+// Sketches with small hashes so the union is easy to follow: k = 21, s = 4
+const std::string SKETCH_1234 =
+    std::string("\x15\x04\x00\x00\x00"
+                "\x01\x00\x00\x00\x00\x00\x00\x00\x02\x00\x00\x00\x00\x00\x00\x00"
+                "\x03\x00\x00\x00\x00\x00\x00\x00\x04\x00\x00\x00\x00\x00\x00\x00",
+                37);
+const std::string SKETCH_3456 =
+    std::string("\x15\x04\x00\x00\x00"
+                "\x03\x00\x00\x00\x00\x00\x00\x00\x04\x00\x00\x00\x00\x00\x00\x00"
+                "\x05\x00\x00\x00\x00\x00\x00\x00\x06\x00\x00\x00\x00\x00\x00\x00",
+                37);
+const std::string SKETCH_7 =
+    std::string("\x15\x04\x00\x00\x00\x07\x00\x00\x00\x00\x00\x00\x00", 13);
+const std::string SKETCH_K4_1 =
+    std::string("\x04\x04\x00\x00\x00\x01\x00\x00\x00\x00\x00\x00\x00", 13);
+// nt_sketch("ACGT", 4, 10): ACGT is its own reverse complement
+const std::string SKETCH_ACGT =
+    std::string("\x04\x0A\x00\x00\x00\xFC\x0E\x2A\x33\x75\x96\x46\x32", 13);
+// nt_sketch("TTTTT", 4, 10): TTTT is read as its reverse complement AAAA, which hashes to 0
+const std::string SKETCH_AAAA =
+    std::string("\x04\x0A\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00", 13);
+
+bool test__nt_sketch() {
+    int passing = true;
+
+    std::tuple<StringVal, IntVal, IntVal, StringVal> table[9] = {
+        std::make_tuple("ACGT", 4, 10, packed_val(SKETCH_ACGT)),
+        std::make_tuple("acgu", 4, 10, packed_val(SKETCH_ACGT)),
+        std::make_tuple("AAAAA", 4, 10, packed_val(SKETCH_AAAA)),
+        std::make_tuple("TTTTT", 4, 10, packed_val(SKETCH_AAAA)),
+        std::make_tuple("ACGNT", 4, 10, StringVal::null()),
+        std::make_tuple("ACGT", 0, 10, StringVal::null()),
+        std::make_tuple("ACGT", 33, 10, StringVal::null()),
+        std::make_tuple("ACGT", 4, 0, StringVal::null()),
+        std::make_tuple(StringVal::null(), 4, 10, StringVal::null())
+    };
+    for (int i = 0; i < 9; i++) {
+        auto [arg0_s, arg1_i, arg2_i, expected] = table[i];
+
+        if (!UdfTestHarness::ValidateUdf<StringVal, StringVal, IntVal, IntVal>(
+                Nt_Sketch_K_S, arg0_s, arg1_i, arg2_i, expected
+            )) {
+            cout << "UDX nt_sketch(sii)->s failed for case " << i << "\n";
+            passing = false;
+        }
+    }
+
+    // Random sequences against sorting every canonical k-mer hash and keeping the s smallest
+    auto splitmix = [](uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    };
+    std::mt19937 rng(42);
+    for (int i = 0; i < 300; i++) {
+        std::string sequence(rng() % 300 + 1, ' ');
+        for (auto &c : sequence) {
+            c = "ACGTN"[rng() % (i % 2 ? 5 : 4)];
+        }
+        const int k      = rng() % 32 + 1;
+        const uint32_t n = rng() % 40 + 1;
+
+        std::vector<uint64_t> hashes;
+        for (std::size_t at = 0; at + k <= sequence.size(); at++) {
+            uint64_t forward = 0, reverse = 0;
+            std::size_t j    = 0;
+            for (; j < std::size_t(k); j++) {
+                const std::size_t code = std::string("ACGT").find(sequence[at + j]);
+                const std::size_t back = std::string("TGCA").find(sequence[at + k - 1 - j]);
+                if (code == std::string::npos || back == std::string::npos) {
+                    break;
+                }
+                forward = forward << 2 | code;
+                reverse = reverse << 2 | back;
+            }
+            if (j == std::size_t(k)) {
+                hashes.push_back(splitmix(std::min(forward, reverse)));
+            }
+        }
+        std::sort(hashes.begin(), hashes.end());
+        hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+        hashes.resize(std::min<std::size_t>(hashes.size(), n));
+
+        std::string packed(5 + 8 * hashes.size(), '\0');
+        packed[0] = k;
+        memcpy(&packed[1], &n, sizeof(n));
+        memcpy(&packed[5], hashes.data(), 8 * hashes.size());
+        StringVal expected = hashes.empty() ? StringVal::null() : packed_val(packed);
+
+        if (!UdfTestHarness::ValidateUdf<StringVal, StringVal, IntVal, IntVal>(
+                Nt_Sketch_K_S, StringVal(sequence.c_str()), IntVal(k), IntVal(n), expected
+            )) {
+            cout << "UDX nt_sketch(sii) Fuzz failed:\n\t|" << sequence << "|\n\t|" << k
+                 << "|\n\t|" << n << "|\n";
+            passing = false;
+        }
+    }
+
+    // sketch1, sketch2, similarity, distance
+    std::tuple<StringVal, StringVal, DoubleVal, DoubleVal> pairs[6] = {
+        std::make_tuple(packed_val(SKETCH_1234), packed_val(SKETCH_1234), 1.0, 0.0),
+        std::make_tuple(
+            packed_val(SKETCH_1234), packed_val(SKETCH_3456), 0.5, 0.019307862290864973
+        ),
+        std::make_tuple(packed_val(SKETCH_1234), packed_val(SKETCH_7), 0.0, 1.0),
+        std::make_tuple(
+            packed_val(SKETCH_1234), packed_val(SKETCH_K4_1), DoubleVal::null(), DoubleVal::null()
+        ),
+        std::make_tuple(packed_val(SKETCH_1234), "ACGT", DoubleVal::null(), DoubleVal::null()),
+        std::make_tuple(
+            StringVal::null(), packed_val(SKETCH_1234), DoubleVal::null(), DoubleVal::null()
+        )
+    };
+    for (int i = 0; i < 6; i++) {
+        auto [arg0_s, arg1_s, sim_expected, dist_expected] = pairs[i];
+
+        if (!UdfTestHarness::ValidateUdf<DoubleVal, StringVal, StringVal>(
+                Sketch_Similarity, arg0_s, arg1_s, sim_expected
+            )) {
+            cout << "UDX sketch_similarity(ss)->d failed for case " << i << ":\n\t|"
+                 << sim_expected.val << "|\n";
+            passing = false;
+        }
+        if (!UdfTestHarness::ValidateUdf<DoubleVal, StringVal, StringVal>(
+                Sketch_Distance, arg0_s, arg1_s, dist_expected
+            )) {
+            cout << "UDX sketch_distance(ss)->d failed for case " << i << ":\n\t|"
+                 << dist_expected.val << "|\n";
+            passing = false;
+        }
     }
 
     return passing;
@@ -1433,7 +2496,7 @@ bool test__sort_list() {
 bool test__sort_list_set() {
     int passing = true;
 
-    std::tuple<StringVal, StringVal, StringVal, StringVal> table[9] = {
+    std::tuple<StringVal, StringVal, StringVal, StringVal> table[10] = {
         std::make_tuple("B;C;A", ";", ":", "A:B:C"),
         std::make_tuple(StringVal::null(), ";", ":", StringVal::null()),
         std::make_tuple("B;C;A", StringVal::null(), ":", StringVal::null()),
@@ -1442,9 +2505,10 @@ bool test__sort_list_set() {
         std::make_tuple("B;C;A", "", ":", "B;C;A"),
         std::make_tuple("BstarkCstarkA", "stark", ":", "A:B:C"),
         std::make_tuple("Ok Bye;Hello, yes!", ";,", ":", " yes!:Hello:Ok Bye"),
-        std::make_tuple("Ok Bye;Hello, yes!", ";", ":", "Hello, yes!:Ok Bye")
+        std::make_tuple("Ok Bye;Hello, yes!", ";", ":", "Hello, yes!:Ok Bye"),
+        std::make_tuple(";,;", ";,", ":", ";,;")
     };
-    for (int i = 0; i < 9; i++) {
+    for (int i = 0; i < 10; i++) {
         auto [arg0_s, arg1_s, arg2_s, expected] = table[i];
 
         if (!UdfTestHarness::ValidateUdf<StringVal, StringVal, StringVal, StringVal>(
@@ -1594,7 +2658,7 @@ bool test__nt_to_aa_position() {
 
 bool test__nt_to_cds_position() {
     int passing                                                   = true;
-    std::tuple<StringVal, StringVal, BigIntVal, IntVal> table[13] = {
+    std::tuple<StringVal, StringVal, BigIntVal, IntVal> table[15] = {
         // "XXXATG"
         std::make_tuple("", "1..3", 3, IntVal::null()),
         std::make_tuple("4..6", "", 3, IntVal::null()),
@@ -1611,11 +2675,13 @@ bool test__nt_to_cds_position() {
         std::make_tuple("4..6;8..10;11..16", "1..3;4..6;7..12", 11, 7),
         // Insertions cannot be returned with this method
         std::make_tuple("1..456;457..459;460..983", "31..486;486;487..1010", 458, IntVal::null()),
-        std::make_tuple("1..456;457..459;460..983", "31..486;486;487..1010", 460, 487)
-
+        std::make_tuple("1..456;457..459;460..983", "31..486;486;487..1010", 460, 487),
+        // Maps must have as many ranges as each other
+        std::make_tuple("4..6;8..10", "1..3", 4, IntVal::null()),
+        std::make_tuple(";4..6;;8..10;", "1..3;4..6", 9, 5)
     };
 
-    for (int i = 0; i < 13; i++) {
+    for (int i = 0; i < 15; i++) {
         auto [arg0_s, arg1_s, arg2_i, expected] = table[i];
 
         if (!UdfTestHarness::ValidateUdf<IntVal, StringVal, StringVal, BigIntVal>(
@@ -1835,6 +2901,15 @@ bool test__to_aa() {
                  << "|\n";
             passing = false;
         }
+
+        // Repeated calls are served from the memo cache
+        if (!UdfTestHarness::ValidateUdf<StringVal, StringVal>(
+                To_AA, arg0_s, expected, Memo_Prepare, Memo_Close
+            )) {
+            cout << "UDX to_aa_cached(s)->s failed:\n\t|" << arg0_s.ptr << "|\n\t|"
+                 << expected.ptr << "|\n";
+            passing = false;
+        }
     }
 
     return passing;
@@ -1863,6 +2938,15 @@ bool test__to_aa3() {
                  << "|\n";
             passing = false;
         }
+
+        // Repeated calls are served from the memo cache
+        if (!UdfTestHarness::ValidateUdf<StringVal, StringVal>(
+                To_AA3, arg0_s, expected, Memo_Prepare, Memo_Close
+            )) {
+            cout << "UDX to_aa3_cached(s)->s failed:\n\t|" << arg0_s.ptr << "|\n\t|"
+                 << expected.ptr << "|\n";
+            passing = false;
+        }
     }
 
     return passing;
@@ -1928,10 +3012,60 @@ bool test__variant_hash() {
     return passing;
 }
 
+bool test__hash_batch() {
+    bool passing = true;
+
+    std::string long_seq = "";
+    for (int i = 0; i < 5000; i++) {
+        long_seq += "a-";
+    }
+
+    std::tuple<std::string, std::string> nt_table[5] = {
+        std::make_tuple("", ""),
+        std::make_tuple(
+            "ATGAACACTCAAATCCTGGTATTCGCTCTGGTGGCGAGCATTCCGACAAATGCA...   ---~~~:::",
+            "198a9b787a7e856b54eea10948bfa6bda5882681"
+        ),
+        std::make_tuple("1", "356a192b7913b04c54574d18c28d46e6395428ab"),
+        std::make_tuple("TCC ACC GCC CGG AAA", "a3505a17b5b0adf08a7d43667e0802a05beedc8c"),
+        std::make_tuple(long_seq, "33e2a1918af3a4127b5a02cbfa7703061b52dc28")
+    };
+    std::tuple<std::string, std::string> aa_table[5] = {
+        std::make_tuple("", ""),
+        std::make_tuple("..MNTQIL---VFA  LVASIPTNA:", "f59e28966a24d41af41cd55ed00c08a4"),
+        std::make_tuple("MNTQILVFALVASIPTNA~", "3476ea2853c1363c8da186016063ef78"),
+        std::make_tuple("1", "c4ca4238a0b923820dcc509a6f75849b"),
+        std::make_tuple("STARK", "a9106b6bc4ae581eb39418098a2891b4")
+    };
+
+    // More sequences than vector lanes, so finished lanes are refilled
+    std::vector<std::string_view> nt_seqs, aa_seqs;
+    std::vector<std::string> nt_expected, aa_expected;
+    for (int r = 0; r < 10; r++) {
+        for (int i = 0; i < 5; i++) {
+            nt_seqs.push_back(std::get<0>(nt_table[i]));
+            nt_expected.push_back(std::get<1>(nt_table[i]));
+            aa_seqs.push_back(std::get<0>(aa_table[i]));
+            aa_expected.push_back(std::get<1>(aa_table[i]));
+        }
+    }
+
+    if (nt_id_batch(nt_seqs) != nt_expected) {
+        cout << "UDX nt_id_batch(v)->v failed\n";
+        passing = false;
+    }
+    if (variant_hash_batch(aa_seqs) != aa_expected) {
+        cout << "UDX variant_hash_batch(v)->v failed\n";
+        passing = false;
+    }
+
+    return passing;
+}
+
 bool test__sequence_diff() {
     bool passing = true;
 
-    std::tuple<StringVal, StringVal, StringVal> table[10] = {
+    std::tuple<StringVal, StringVal, StringVal> table[11] = {
         std::make_tuple(StringVal("AGAGA"), StringVal("AGAGA"), StringVal(".....")),
         std::make_tuple(StringVal::null(), StringVal("AGAGA"), StringVal::null()),
         std::make_tuple(StringVal("AGAGA"), StringVal::null(), StringVal::null()),
@@ -1941,10 +3075,15 @@ bool test__sequence_diff() {
         std::make_tuple(StringVal("AaAGA"), StringVal("AGAGA"), StringVal(".G...")),
         std::make_tuple(StringVal("AGAGAG"), StringVal("AGAGA"), StringVal(".....")),
         std::make_tuple(StringVal("AGAGAGGAGAG"), StringVal("AGAGA"), StringVal(".....")),
-        std::make_tuple(StringVal("AGAG"), StringVal("AGAGAGAGAA"), StringVal("...."))
+        std::make_tuple(StringVal("AGAG"), StringVal("AGAGAGAGAA"), StringVal("....")),
+        std::make_tuple(
+            StringVal("acgtACGTnnnnNNNN`{@[zZacgtrykmACGTRYKMacgu-"),
+            StringVal("ACGTacgtACGTacgt@[`{ZzaaaaaaaaRYKMrykmACGT-"),
+            StringVal("........ACGTACGT@[`{...AAAAAAARYKM.......T.")
+        )
     };
 
-    for (int i = 0; i < 10; i++) {
+    for (int i = 0; i < 11; i++) {
         auto [arg0_s, arg1_s, expected] = table[i];
         if (!UdfTestHarness::ValidateUdf<StringVal, StringVal, StringVal>(
                 Sequence_Diff, arg0_s, arg1_s, expected
@@ -1960,7 +3099,7 @@ bool test__sequence_diff() {
 bool test__sequence_diff_nt() {
     bool passing = true;
 
-    std::tuple<StringVal, StringVal, StringVal> table[18] = {
+    std::tuple<StringVal, StringVal, StringVal> table[19] = {
         std::make_tuple(StringVal("AGCTN-@"), StringVal("AGCTN-@"), StringVal("......?")),
         std::make_tuple(StringVal("AGAGA"), StringVal("AGAGA"), StringVal(".....")),
         std::make_tuple(StringVal::null(), StringVal::null(), StringVal::null()),
@@ -1986,9 +3125,14 @@ bool test__sequence_diff_nt() {
             StringVal("TTTTTTTTTTT"), StringVal("WKYBDHNSMRV"), StringVal(".......SMRV")
         ),
         std::make_tuple(StringVal("TTTTTTT"), StringVal("UKRBVHN"), StringVal("..R.V..")),
-        std::make_tuple(StringVal("AAAA-A"), StringVal("AGA-AA"), StringVal(".G.-A."))
+        std::make_tuple(StringVal("AAAA-A"), StringVal("AGA-AA"), StringVal(".G.-A.")),
+        std::make_tuple(
+            StringVal("acgtACGTnnnnNNNN`{@[zZacgtrykmACGTRYKMacgu-"),
+            StringVal("ACGTacgtACGTacgt@[`{ZzaaaaaaaaRYKMrykmACGT-"),
+            StringVal("................??????.aaa.aa....M.........")
+        )
     };
-    for (int i = 0; i < 18; i++) {
+    for (int i = 0; i < 19; i++) {
         auto [arg0_s, arg1_s, expected] = table[i];
         if (!UdfTestHarness::ValidateUdf<StringVal, StringVal, StringVal>(
                 Sequence_Diff_NT, arg0_s, arg1_s, expected
@@ -2096,13 +3240,16 @@ int main(int argc, char **argv) {
     passed &= test__any_instr();
     passed &= test__complete_date();
     passed &= test__contains_element();
+    passed &= test__contains_element_fuzz();
     passed &= test__contains_sym();
+    passed &= test__contains_sym_ignore_case();
     passed &= test__cut_paste();
     passed &= test__cut_paste_out();
     passed &= test__deletion_events();
     passed &= test__hamming_distance();
     passed &= test__hamming_distance_pds();
     passed &= test__is_element();
+    passed &= test__is_element_set();
     passed &= test__longest_deletion();
     passed &= test__mutation_list();
     passed &= test__mutation_list_range();
@@ -2110,7 +3257,16 @@ int main(int argc, char **argv) {
     passed &= test__mutation_list_indel_gly();
     passed &= test__mutation_list_nt();
     passed &= test__nt_distance();
+    passed &= test__nearest_reference();
+    passed &= test__nt_pack();
+    passed &= test__nt_unpack();
+    passed &= test__packed_distances();
+    passed &= test__align_to_reference();
     passed &= test__nt_id();
+    passed &= test__nt_std_aa_std();
+    passed &= test__hash_batch();
+    passed &= test__fingerprint();
+    passed &= test__nt_sketch();
     passed &= test__pcd();
     passed &= test__range_from_list();
     passed &= test__to_aa();
@@ -2121,6 +3277,8 @@ int main(int argc, char **argv) {
     passed &= test__nt_position_to_codon_mutant();
     passed &= test__ending_in_saturday_str();
     passed &= test__ending_in_fornight_str();
+    passed &= test__period_ending_date();
+    passed &= test__epi_week();
     passed &= test__date_to_double();
     passed &= test__double_to_date();
     passed &= test__doubleday_fuzz();
@@ -11,7 +11,10 @@
 #include <boost/xpressive/xpressive.hpp>
 #include <cctype>
 #include <cmath>
+#include <fstream>
+#include <limits>
 #include <locale>
+#include <memory>
 #include <openssl/md5.h>
 #include <openssl/sha.h>
 #include <set>
@@ -20,18 +23,91 @@
 #include <unordered_map>
 #include <vector>
 
-#include "boost/date_time/gregorian/gregorian.hpp"
 #include <boost/exception/all.hpp>
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 #include "udf-bioutils.h"
+#include "udx-ahocorasick.h"
+#include "udx-align.h"
+#include "udx-byteset.h"
+#include "udx-calendar.h"
+#include "udx-hash.h"
 #include "udx-inlines.h"
 #include "udx-matrix.h"
+#include "udx-memo.h"
+#include "udx-multihash.h"
+#include "udx-packed.h"
+#include "udx-sketch.h"
+#include "udx-stringset.h"
+#include "udx-strsearch.h"
 
 #define PTM_GLY_WINDOW_SIZE 5
 
 
 // Utility functions
 
+// Opt-in result cache for functions registered with these hooks, see udx-memo.h
+IMPALA_UDF_EXPORT
+void Memo_Prepare(FunctionContext *context, FunctionContext::FunctionStateScope scope) {
+    if (scope != FunctionContext::THREAD_LOCAL) {
+        return;
+    }
+    context->SetFunctionState(scope, new MemoCache(MEMO_BUDGET));
+}
+
+IMPALA_UDF_EXPORT
+void Memo_Close(FunctionContext *context, FunctionContext::FunctionStateScope scope) {
+    if (scope != FunctionContext::THREAD_LOCAL) {
+        return;
+    }
+
+    MemoCache *cache = reinterpret_cast<MemoCache *>(context->GetFunctionState(scope));
+    if (cache != NULL && cache->hits + cache->misses > 0) {
+        std::string stats = "Memo cache hits/misses/evictions: " + std::to_string(cache->hits) +
+                            "/" + std::to_string(cache->misses) + "/" +
+                            std::to_string(cache->evictions);
+        context->AddWarning(stats.c_str());
+    }
+    delete cache;
+    context->SetFunctionState(scope, NULL);
+}
+
+// Per-thread cache of parsed date strings for the STRING date functions, see udx-inlines.h
+IMPALA_UDF_EXPORT
+void Date_Parse_Prepare(FunctionContext *context, FunctionContext::FunctionStateScope scope) {
+    if (scope != FunctionContext::THREAD_LOCAL) {
+        return;
+    }
+    context->SetFunctionState(scope, new DateParseCache());
+}
+
+IMPALA_UDF_EXPORT
+void Date_Parse_Close(FunctionContext *context, FunctionContext::FunctionStateScope scope) {
+    if (scope != FunctionContext::THREAD_LOCAL) {
+        return;
+    }
+
+    DateParseCache *cache = reinterpret_cast<DateParseCache *>(context->GetFunctionState(scope));
+    if (cache != NULL && cache->hits + cache->misses > 0) {
+        std::string stats = "Date parse cache hits/misses: " + std::to_string(cache->hits) + "/" +
+                            std::to_string(cache->misses);
+        context->AddWarning(stats.c_str());
+    }
+    delete cache;
+    context->SetFunctionState(scope, NULL);
+}
+
+// Parses through the thread-local cache when the function was prepared with Date_Parse_Prepare
+inline bool parse_date_cached(FunctionContext *context, std::string_view date, int32_t &days) {
+    DateParseCache *cache = reinterpret_cast<DateParseCache *>(
+        context->GetFunctionState(FunctionContext::THREAD_LOCAL)
+    );
+    return cache == NULL ? parse_date_string(date, days) : cache->parse(date, days);
+}
+
 
 // We take a string of delimited values in a string and sort it in ascending
 // order
@@ -171,29 +247,22 @@ StringVal Sort_List_By_Set(
         return listVal;
     };
 
-    std::vector<std::string> tokens;
-    std::string list((const char *)listVal.ptr, listVal.len);
-    std::string delim((const char *)delimVal.ptr, delimVal.len);
-
-    std::string odelim = "";
-    if (outDelimVal.len > 0) {
-        odelim.assign((const char *)outDelimVal.ptr, outDelimVal.len);
-    }
+    std::string_view list((const char *)listVal.ptr, listVal.len);
+    std::string_view delim((const char *)delimVal.ptr, delimVal.len);
+    std::string_view odelim((const char *)outDelimVal.ptr, outDelimVal.len);
 
-    // Initialize positions
-    std::string::size_type lastPos = list.find_first_not_of(delim, 0);
-    std::string::size_type pos     = list.find_first_of(delim, lastPos);
-    while (std::string::npos != pos || std::string::npos != lastPos) {
-        tokens.push_back(list.substr(lastPos, pos - lastPos));
-        lastPos = list.find_first_not_of(delim, pos);
-        pos     = list.find_first_of(delim, lastPos);
+    // Any character of the delimiter separates tokens
+    std::vector<std::string_view> tokens = split_by_delims(list, delim);
+    if (tokens.empty()) {
+        return listVal;
     }
 
     // Use the usual ascending sort
     std::sort(tokens.begin(), tokens.end());
-    std::string s = tokens[0];
-    for (std::vector<std::string>::const_iterator i = tokens.begin() + 1; i < tokens.end(); ++i) {
-        s += odelim + *i;
+    std::string s(tokens[0]);
+    for (auto i = tokens.begin() + 1; i < tokens.end(); ++i) {
+        s += odelim;
+        s += *i;
     }
 
     return to_StringVal(context, s);
@@ -253,21 +322,21 @@ StringVal Sort_Allele_List(
     std::string_view list(reinterpret_cast<const char *>(listVal.ptr), listVal.len);
     std::string_view delim(reinterpret_cast<const char *>(delimVal.ptr), delimVal.len);
 
-    auto tokens = split_by_substr(list, delim);
+    std::vector<Allele> alleles;
+    for (std::string_view token : tokens_by_substr(list, delim)) {
+        alleles.emplace_back(parse_allele(token));
+    }
 
-    if (tokens.empty()) {
+    if (alleles.empty()) {
         return listVal;
     } else {
-        std::vector<Allele> alleles;
-        for (auto token : tokens) {
-            alleles.emplace_back(parse_allele(token));
-        }
 
         std::sort(alleles.begin(), alleles.end(), comp_allele_struct);
 
         std::string sortedList(alleles[0].originalAllele);
         for (size_t i = 1; i < alleles.size(); i++) {
-            sortedList += std::string(delim) + std::string(alleles[i].originalAllele);
+            sortedList += delim;
+            sortedList += alleles[i].originalAllele;
         }
 
         return to_StringVal(context, sortedList);
@@ -304,6 +373,32 @@ StringVal Sort_Site_List(FunctionContext *context, const StringVal &listVal) {
     }
 }
 
+// A constant set of needles is compiled once into a bitmap of its bytes
+IMPALA_UDF_EXPORT
+void Find_Set_Prepare(FunctionContext *context, FunctionContext::FunctionStateScope scope) {
+    if (scope != FunctionContext::FRAGMENT_LOCAL || !context->IsArgConstant(1)) {
+        return;
+    }
+
+    const StringVal *needlesVal = reinterpret_cast<const StringVal *>(context->GetConstantArg(1));
+    if (needlesVal == NULL || needlesVal->is_null) {
+        return;
+    }
+    std::string_view needles((const char *)needlesVal->ptr, needlesVal->len);
+    context->SetFunctionState(scope, new ByteSet(needles));
+}
+
+IMPALA_UDF_EXPORT
+void Find_Set_Close(FunctionContext *context, FunctionContext::FunctionStateScope scope) {
+    if (scope != FunctionContext::FRAGMENT_LOCAL) {
+        return;
+    }
+
+    ByteSet *needles = reinterpret_cast<ByteSet *>(context->GetFunctionState(scope));
+    delete needles;
+    context->SetFunctionState(scope, NULL);
+}
+
 IMPALA_UDF_EXPORT
 BooleanVal Find_Set_In_String(
     FunctionContext *context, const StringVal &haystackVal, const StringVal &needlesVal
@@ -323,15 +418,20 @@ BooleanVal Find_Set_In_String(
         }
         // haystack and needles are non-trivial
     } else {
-        std::string haystack((const char *)haystackVal.ptr, haystackVal.len);
-        std::string needles((const char *)needlesVal.ptr, needlesVal.len);
-        return BooleanVal(haystack.find_first_of(needles) != std::string::npos);
+        std::string_view haystack((const char *)haystackVal.ptr, haystackVal.len);
+        const ByteSet *needle_set = reinterpret_cast<const ByteSet *>(
+            context->GetFunctionState(FunctionContext::FRAGMENT_LOCAL)
+        );
+        if (needle_set != NULL) {
+            return BooleanVal(needle_set->search(haystack));
+        }
+        std::string_view needles((const char *)needlesVal.ptr, needlesVal.len);
+        return BooleanVal(ByteSet(needles).search(haystack));
     }
 }
 
 // We take codon(s) and translate it/them
-IMPALA_UDF_EXPORT
-StringVal To_AA(FunctionContext *context, const StringVal &ntsVal) {
+static StringVal compute_to_aa(FunctionContext *context, const StringVal &ntsVal) {
     if (ntsVal.is_null) {
         return StringVal::null();
     }
@@ -375,6 +475,11 @@ StringVal To_AA(FunctionContext *context, const StringVal &ntsVal) {
     return to_StringVal(context, residues);
 }
 
+IMPALA_UDF_EXPORT
+StringVal To_AA(FunctionContext *context, const StringVal &ntsVal) {
+    return memoized(context, compute_to_aa, ntsVal);
+}
+
 inline std::string codon_to_aa3(std::string codon, const std::size_t total_length) {
     std::string aa;
 
@@ -402,8 +507,7 @@ inline std::string codon_to_aa3(std::string codon, const std::size_t total_lengt
 }
 
 // We take codon(s) and translate it/them
-IMPALA_UDF_EXPORT
-StringVal To_AA3(FunctionContext *context, const StringVal &ntsVal) {
+static StringVal compute_to_aa3(FunctionContext *context, const StringVal &ntsVal) {
     if (ntsVal.is_null) {
         return StringVal::null();
     }
@@ -431,6 +535,11 @@ StringVal To_AA3(FunctionContext *context, const StringVal &ntsVal) {
     return to_StringVal(context, residues);
 }
 
+IMPALA_UDF_EXPORT
+StringVal To_AA3(FunctionContext *context, const StringVal &ntsVal) {
+    return memoized(context, compute_to_aa3, ntsVal);
+}
+
 // Allows for mutating an allele before translation
 IMPALA_UDF_EXPORT
 StringVal To_AA_Mutant(
@@ -490,123 +599,60 @@ StringVal Complete_String_Date(FunctionContext *context, const StringVal &dateSt
         return StringVal::null();
     }
 
-    std::string date((const char *)dateStr.ptr, dateStr.len);
-    std::vector<std::string> tokens;
-    boost::split(tokens, date, boost::is_any_of("-/."));
-
-    std::string buffer = "";
-    if (tokens.size() >= 3) {
-        buffer = tokens[0] + "-" + tokens[1] + "-" + tokens[2];
-    } else if (tokens.size() == 2) {
-        buffer = tokens[0] + "-" + tokens[1] + "-01";
-    } else if (tokens.size() == 1) {
-        if (tokens[0].length() == 4) {
-            buffer = tokens[0];
-            buffer += "-01-01";
-        } else if (tokens[0].length() == 6) {
-            buffer = "20";
-            buffer += tokens[0][0];
-            buffer += tokens[0][1];
-            buffer += "-";
-            buffer += tokens[0][2];
-            buffer += tokens[0][3];
-            buffer += "-";
-            buffer += tokens[0][4];
-            buffer += tokens[0][5];
-        } else {
-            return StringVal::null();
-        }
+    std::string_view date((const char *)dateStr.ptr, dateStr.len);
+    std::string_view fields[3];
+    std::size_t count = split_date_fields(date, fields);
+
+    std::string_view year, month = "01", day = "01";
+    char century[4] = {'2', '0'};
+    if (count >= 3) {
+        year  = fields[0];
+        month = fields[1];
+        day   = fields[2];
+    } else if (count == 2) {
+        year  = fields[0];
+        month = fields[1];
+    } else if (fields[0].length() == 4) {
+        year = fields[0];
+    } else if (fields[0].length() == 6) {
+        century[2] = fields[0][0];
+        century[3] = fields[0][1];
+        year       = std::string_view(century, 4);
+        month      = fields[0].substr(2, 2);
+        day        = fields[0].substr(4, 2);
     } else {
         return StringVal::null();
     }
 
-    return to_StringVal(context, buffer);
-}
-
-// Convert Grogorian Dates to the EPI (MMWR) Week
-// See: https://wwwn.cdc.gov/nndss/document/MMWR_Week_overview.pdf
-struct epiweek_t date_to_epiweek(boost::gregorian::date d) {
-    // Boost starts with Sunday.
-    int day_of_year = d.day_of_year();
-    int weekday     = d.day_of_week();
-
-    boost::gregorian::date start_date(d.year(), 1, 1);
-    int start_weekday = start_date.day_of_week();
-    boost::gregorian::date next_year_date(d.year() + 1, 1, 1);
-    int next_year_weekday = next_year_date.day_of_week();
-
-    // December & 29 - 31 &  Sun-Tues & Next year is Sun-Thu
-    if (d.month() == 12 && d.day() > 28 && weekday < 3 && next_year_weekday < 4) {
-        struct epiweek_t result = {d.year() + 1, 1};
-        return result;
-    }
-
-    int epiweek = (day_of_year + (start_weekday - 1)) / 7;
-    // Sunday, Monday, Tuesday, Wednesday
-    if (start_weekday < 4) {
-        epiweek++;
-    }
-
-    if (epiweek > 0) {
-        struct epiweek_t result = {d.year(), epiweek};
+    StringVal result(context, year.size() + month.size() + day.size() + 2);
+    if (result.is_null) {
         return result;
-    } else {
-        boost::gregorian::date last_year_date(d.year() - 1, 12, 31);
-        return date_to_epiweek(last_year_date);
-    }
-}
-
-DateVal ending_in_Saturday(boost::gregorian::date d) {
-    // Boost starts with Sunday: 0 to 6
-    boost::gregorian::date_duration days_until_saturday(6 - d.day_of_week());
-    d += days_until_saturday;
-
-    // Stored as the Days since the Unix Epoch
-    return DateVal(d.day_number() - EPOCH_OFFSET);
-}
-
-// Calculation inspired by work from C. Paden
-DateVal ending_in_Fortnight(boost::gregorian::date d, bool legacy_default_week) {
-    // Final saturday should always be greater than d
-    int diff = FINAL_SATURDAY - d.day_number();
-    // Changes which week the 2-week period ends at
-    if (legacy_default_week) {
-        diff += 7;
     }
-    boost::gregorian::date_duration days_until_fortnight(diff % 14);
-    d += days_until_fortnight;
-
-    // Stored as the Days since the Unix Epoch
-    return DateVal(d.day_number() - EPOCH_OFFSET);
+    uint8_t *out = result.ptr;
+    memcpy(out, year.data(), year.size());
+    out += year.size();
+    *out++ = '-';
+    memcpy(out, month.data(), month.size());
+    out += month.size();
+    *out++ = '-';
+    memcpy(out, day.data(), day.size());
+    return result;
 }
 
-
 IMPALA_UDF_EXPORT
 DateVal Date_Ending_In_Saturday_DATE(FunctionContext *context, const DateVal &dateVal) {
-    if (dateVal.is_null) {
+    if (dateVal.is_null || !is_valid_days(dateVal.val)) {
         return DateVal::null();
-    } else {
-        try {
-            auto d = boost::gregorian::date(dateVal.val + EPOCH_OFFSET);
-            return ending_in_Saturday(d);
-        } catch (...) {
-            return DateVal::null();
-        }
     }
+    return DateVal(saturday_ending(dateVal.val));
 }
 
 IMPALA_UDF_EXPORT
 DateVal Date_Ending_In_Saturday_TS(FunctionContext *context, const TimestampVal &tsVal) {
-    if (tsVal.is_null) {
+    if (tsVal.is_null || !is_valid_days(tsVal.date - EPOCH_OFFSET)) {
         return DateVal::null();
-    } else {
-        try {
-            boost::gregorian::date d(tsVal.date);
-            return ending_in_Saturday(d);
-        } catch (...) {
-            return DateVal::null();
-        }
     }
+    return DateVal(saturday_ending(tsVal.date - EPOCH_OFFSET));
 }
 
 IMPALA_UDF_EXPORT
@@ -615,23 +661,11 @@ DateVal Date_Ending_In_Saturday_STR(FunctionContext *context, const StringVal &d
         return DateVal::null();
     }
     std::string_view date((const char *)dateStr.ptr, dateStr.len);
-    std::vector<std::string> tokens;
-    boost::split(tokens, date, boost::is_any_of("-/."));
-
-    try {
-        int year, month, day;
-        if (tokens.size() >= 3) {
-            year  = std::stoi(tokens[0]);
-            month = std::stoi(tokens[1]);
-            day   = std::stoi(tokens[2]);
-        } else {
-            return DateVal::null();
-        }
-        boost::gregorian::date d(year, month, day);
-        return ending_in_Saturday(d);
-    } catch (...) {
+    int32_t days;
+    if (!parse_date_cached(context, date, days)) {
         return DateVal::null();
     }
+    return DateVal(saturday_ending(days));
 }
 
 IMPALA_UDF_EXPORT
@@ -654,32 +688,20 @@ IMPALA_UDF_EXPORT
 DateVal Fortnight_Date_Either(
     FunctionContext *context, const DateVal &dateVal, const BooleanVal &legacy_default_week
 ) {
-    if (dateVal.is_null || legacy_default_week.is_null) {
+    if (dateVal.is_null || legacy_default_week.is_null || !is_valid_days(dateVal.val)) {
         return DateVal::null();
-    } else {
-        try {
-            auto d = boost::gregorian::date(dateVal.val + EPOCH_OFFSET);
-            return ending_in_Fortnight(d, legacy_default_week.val);
-        } catch (...) {
-            return DateVal::null();
-        }
     }
+    return DateVal(fortnight_ending(dateVal.val, legacy_default_week.val));
 }
 
 IMPALA_UDF_EXPORT
 DateVal Fortnight_Date_Either_TS(
     FunctionContext *context, const TimestampVal &tsVal, const BooleanVal &legacy_default_week
 ) {
-    if (tsVal.is_null || legacy_default_week.is_null) {
+    if (tsVal.is_null || legacy_default_week.is_null || !is_valid_days(tsVal.date - EPOCH_OFFSET)) {
         return DateVal::null();
-    } else {
-        try {
-            boost::gregorian::date d(tsVal.date);
-            return ending_in_Fortnight(d, legacy_default_week.val);
-        } catch (...) {
-            return DateVal::null();
-        }
     }
+    return DateVal(fortnight_ending(tsVal.date - EPOCH_OFFSET, legacy_default_week.val));
 }
 
 IMPALA_UDF_EXPORT
@@ -691,23 +713,108 @@ DateVal Fortnight_Date_Either_STR(
     }
 
     std::string_view date((const char *)dateStr.ptr, dateStr.len);
-    std::vector<std::string> tokens;
-    boost::split(tokens, date, boost::is_any_of("-/."));
-
-    try {
-        int year, month, day;
-        if (tokens.size() >= 3) {
-            year  = std::stoi(tokens[0]);
-            month = std::stoi(tokens[1]);
-            day   = std::stoi(tokens[2]);
-        } else {
-            return DateVal::null();
-        }
-        boost::gregorian::date d(year, month, day);
-        return ending_in_Fortnight(d, legacy_default_week.val);
-    } catch (...) {
+    int32_t days;
+    if (!parse_date_cached(context, date, days)) {
+        return DateVal::null();
+    }
+    return DateVal(fortnight_ending(days, legacy_default_week.val));
+}
+
+// A constant period and anchor are resolved once per fragment, see period_t in udx-calendar.h.
+// Each thread also gets a date parse cache for the STRING variant.
+IMPALA_UDF_EXPORT
+void Period_Ending_Prepare(FunctionContext *context, FunctionContext::FunctionStateScope scope) {
+    if (scope == FunctionContext::THREAD_LOCAL) {
+        Date_Parse_Prepare(context, scope);
+        return;
+    }
+    if (!context->IsArgConstant(1) || !context->IsArgConstant(2)) {
+        return;
+    }
+
+    const IntVal *periodVal  = reinterpret_cast<const IntVal *>(context->GetConstantArg(1));
+    const DateVal *anchorVal = reinterpret_cast<const DateVal *>(context->GetConstantArg(2));
+    if (periodVal == NULL || anchorVal == NULL || periodVal->is_null || anchorVal->is_null ||
+        !is_valid_period(periodVal->val)) {
+        return;
+    }
+    context->SetFunctionState(scope, new period_t(make_period(periodVal->val, anchorVal->val)));
+}
+
+IMPALA_UDF_EXPORT
+void Period_Ending_Close(FunctionContext *context, FunctionContext::FunctionStateScope scope) {
+    if (scope == FunctionContext::THREAD_LOCAL) {
+        Date_Parse_Close(context, scope);
+        return;
+    }
+
+    period_t *period = reinterpret_cast<period_t *>(context->GetFunctionState(scope));
+    delete period;
+    context->SetFunctionState(scope, NULL);
+}
+
+// Returns the prepared period, or resolves a non-constant one into row_period. NULL when the period
+// is null, not positive or longer than the range of valid dates.
+inline const period_t *resolve_period(
+    FunctionContext *context, const IntVal &periodVal, const DateVal &anchorVal,
+    period_t &row_period
+) {
+    const period_t *period = reinterpret_cast<const period_t *>(
+        context->GetFunctionState(FunctionContext::FRAGMENT_LOCAL)
+    );
+    if (period != NULL) {
+        return period;
+    }
+    if (periodVal.is_null || anchorVal.is_null || !is_valid_period(periodVal.val)) {
+        return NULL;
+    }
+    row_period = make_period(periodVal.val, anchorVal.val);
+    return &row_period;
+}
+
+IMPALA_UDF_EXPORT
+DateVal Period_Ending_Date(
+    FunctionContext *context, const DateVal &dateVal, const IntVal &periodVal,
+    const DateVal &anchorVal
+) {
+    period_t row_period;
+    const period_t *period = resolve_period(context, periodVal, anchorVal, row_period);
+    if (dateVal.is_null || period == NULL || !is_valid_days(dateVal.val)) {
+        return DateVal::null();
+    }
+    return DateVal(period_ending(dateVal.val, *period));
+}
+
+IMPALA_UDF_EXPORT
+DateVal Period_Ending_Date_TS(
+    FunctionContext *context, const TimestampVal &tsVal, const IntVal &periodVal,
+    const DateVal &anchorVal
+) {
+    period_t row_period;
+    const period_t *period = resolve_period(context, periodVal, anchorVal, row_period);
+    if (tsVal.is_null || period == NULL || !is_valid_days(tsVal.date - EPOCH_OFFSET)) {
+        return DateVal::null();
+    }
+    return DateVal(period_ending(tsVal.date - EPOCH_OFFSET, *period));
+}
+
+IMPALA_UDF_EXPORT
+DateVal Period_Ending_Date_STR(
+    FunctionContext *context, const StringVal &dateStr, const IntVal &periodVal,
+    const DateVal &anchorVal
+) {
+    period_t row_period;
+    const period_t *period = resolve_period(context, periodVal, anchorVal, row_period);
+    if (dateStr.is_null || dateStr.len == 0 || period == NULL) {
+        return DateVal::null();
+    }
+
+    std::string_view date((const char *)dateStr.ptr, dateStr.len);
+    int32_t days;
+    if (!parse_date_cached(context, date, days)) {
         return DateVal::null();
     }
+    return DateVal(period_ending(days, *period));
 }
 
 
@@ -720,20 +827,15 @@ IMPALA_UDF_EXPORT
 IntVal Convert_Timestamp_To_EPI_Week(
     FunctionContext *context, const TimestampVal &tsVal, const BooleanVal &yearFormat
 ) {
-    if (tsVal.is_null || yearFormat.is_null) {
+    if (tsVal.is_null || yearFormat.is_null || !is_valid_days(tsVal.date - EPOCH_OFFSET)) {
         return IntVal::null();
     }
 
-    try {
-        boost::gregorian::date d(tsVal.date);
-        struct epiweek_t epi = date_to_epiweek(d);
-        if (yearFormat.val) {
-            return IntVal(epi.year * 100 + epi.week);
-        } else {
-            return IntVal(epi.week);
-        }
-    } catch (...) {
-        return IntVal::null();
+    struct epiweek_t epi = days_to_epiweek(tsVal.date - EPOCH_OFFSET);
+    if (yearFormat.val) {
+        return IntVal(epi.year * 100 + epi.week);
+    } else {
+        return IntVal(epi.week);
     }
 }
 
@@ -749,38 +851,35 @@ IntVal Convert_String_To_EPI_Week(
     if (dateStr.is_null || dateStr.len == 0 || yearFormat.is_null) {
         return IntVal::null();
     }
-    std::string date((const char *)dateStr.ptr, dateStr.len);
-    std::vector<std::string> tokens;
-    boost::split(tokens, date, boost::is_any_of("-/."));
-
-    try {
-        int year, month, day;
-        if (tokens.size() >= 3) {
-            year  = std::stoi(tokens[0]);
-            month = std::stoi(tokens[1]);
-            day   = std::stoi(tokens[2]);
-        } else {
-            return IntVal::null();
-        }
-
-        boost::gregorian::date d(year, month, day);
-        struct epiweek_t epi = date_to_epiweek(d);
-        if (yearFormat.val) {
-            return IntVal(epi.year * 100 + epi.week);
-        } else {
-            return IntVal(epi.week);
-        }
-    } catch (...) {
+    std::string_view date((const char *)dateStr.ptr, dateStr.len);
+    int32_t days;
+    if (!parse_date_cached(context, date, days)) {
         return IntVal::null();
     }
+
+    struct epiweek_t epi = days_to_epiweek(days);
+    if (yearFormat.val) {
+        return IntVal(epi.year * 100 + epi.week);
+    } else {
+        return IntVal(epi.week);
+    }
 }
 
+// Valid dates take the year's start and length from YEAR_START_TABLE, others are computed
 __attribute__((visibility("default")))
 double date_to_double_inner(int32_t dateval) {
-    auto d = boost::gregorian::date(dateval + EPOCH_OFFSET);
-    if (d.day() == 31 && d.month() == 12) return (d.year() + 0.999);
-    int days_in_year = 365 + int(boost::gregorian::gregorian_calendar::is_leap_year(d.year()));
-    double ratio = d.year() + static_cast<double>(d.day_of_year()) / days_in_year;
+    int year, start, days_in_year;
+    if (is_valid_days(dateval)) {
+        year         = year_from_days(dateval);
+        start        = year_start(year);
+        days_in_year = year_start(year + 1) - start;
+    } else {
+        year         = civil_from_days(dateval).year;
+        start        = days_from_civil(year, 1, 1);
+        days_in_year = 365 + int(is_leap_year(year));
+    }
+    if (dateval - start == days_in_year - 1) return (year + 0.999);
+    double ratio = year + static_cast<double>(dateval - start + 1) / days_in_year;
     // Round to 3 decimal places
     double rounded = std::round(ratio * 1000.0) / 1000.0;
     return rounded;
@@ -789,7 +888,7 @@ double date_to_double_inner(int32_t dateval) {
 // Convert Gregorian Date to float for portion of the year passed
 IMPALA_UDF_EXPORT
 DoubleVal Date_to_Double(FunctionContext *context, const DateVal &dateVal) {
-    if (dateVal.is_null) return DoubleVal::null();
+    if (dateVal.is_null || !is_valid_days(dateVal.val)) return DoubleVal::null();
     double result = date_to_double_inner(dateVal.val);
     return DoubleVal(result);
 }
@@ -798,17 +897,26 @@ __attribute__((visibility("default")))
 int32_t double_to_date_inner(double doubleval) {
     double year;
     double decimal = std::modf(doubleval, &year);
-    int days_in_year = 365 + int(boost::gregorian::gregorian_calendar::is_leap_year(year));
+    int start, days_in_year;
+    if (year >= DATE_MIN_YEAR && year <= DATE_MAX_YEAR) {
+        start        = year_start(year);
+        days_in_year = year_start(year + 1) - start;
+    } else {
+        start        = days_from_civil(year, 1, 1);
+        days_in_year = 365 + int(is_leap_year(year));
+    }
     double day_of_year = std::round(days_in_year * decimal);
 
-    auto result = boost::gregorian::date(year, 1, 1) + boost::gregorian::date_duration(day_of_year - 1);
-    int32_t impala_val = result.day_number() - EPOCH_OFFSET;
-    return impala_val;
+    return start + static_cast<int32_t>(day_of_year) - 1;
 }
 
 IMPALA_UDF_EXPORT
 DateVal Double_to_Date(FunctionContext *context, const DoubleVal &doubleVal) {
-    if (doubleVal.is_null) return DateVal::null();
+    // Written so that NaN is rejected too
+    if (doubleVal.is_null ||
+        !(doubleVal.val >= DATE_MIN_YEAR && doubleVal.val < DATE_MAX_YEAR + 1)) {
+        return DateVal::null();
+    }
     int32_t result = double_to_date_inner(doubleVal.val);
     return DateVal(result);
 }
@@ -844,31 +952,36 @@ IntVal NT_To_CDS_Position(
     std::string_view cds((const char *)cdsMap.ptr, cdsMap.len);
     int ori_pos = oriPos.val;
 
-    std::vector<std::string_view> ori_tokens = split_by_delims(ori, ";");
-    std::vector<std::string_view> cds_tokens = split_by_delims(cds, ";");
-
-    if (ori_tokens.size() != cds_tokens.size()) {
-        return IntVal::null();
-    }
-
-    for (int i = 0; i < ori_tokens.size(); i++) {
-        std::vector<int> ori_range = split_int_by_substr(ori_tokens[i], "..");
+    // The maps are walked in step; they must have as many ranges as each other
+    auto ori_tokens = tokens_by_substr(ori, ";");
+    auto cds_tokens = tokens_by_substr(cds, ";");
+    auto ori_it     = ori_tokens.begin();
+    auto cds_it     = cds_tokens.begin();
+    IntVal result   = IntVal::null();
+    for (; ori_it != ori_tokens.end() && cds_it != cds_tokens.end(); ++ori_it, ++cds_it) {
+        if (!result.is_null) {
+            continue;
+        }
 
+        int ori_range[2];
+        int cds_range[2];
         // We must be in range
-        if (ori_range.size() == 2 && ori_range[0] <= ori_pos && ori_pos <= ori_range[1]) {
+        if (parse_int_range(*ori_it, "..", ori_range) == 2 && ori_range[0] <= ori_pos &&
+            ori_pos <= ori_range[1]) {
             // The CDS is a subset of the nt sequence, so only co-ranges may be considered
-            std::vector<int> cds_range = split_int_by_substr(cds_tokens[i], "..");
-            if (cds_range.size() == 2) {
+            if (parse_int_range(*cds_it, "..", cds_range) == 2) {
                 int offset = ori_pos - ori_range[0];
                 // We only care about the first matching range found, but theoretically CDS
                 // could have overlapping exons.
-                return IntVal(cds_range[0] + offset);
+                result = IntVal(cds_range[0] + offset);
             }
         }
     }
 
-    // Ultimately not found
-    return IntVal::null();
+    if (ori_it != ori_tokens.end() || cds_it != cds_tokens.end()) {
+        return IntVal::null();
+    }
+    return result;
 }
 
 
@@ -1021,6 +1134,89 @@ Substring_By_Range(FunctionContext *context, const StringVal &sequence, const St
     return to_StringVal(context, buffer);
 }
 
+// Field ranges of a cut_paste map, 0-based and in output order, with the number of fields that
+// must be tokenized to reach all of them
+struct cut_map_t {
+    bool valid;
+    int max_field;
+    std::vector<std::pair<int, int>> ranges;
+};
+
+inline void compile_cut_map(std::string_view map, cut_map_t &cut) {
+    cut.valid     = true;
+    cut.max_field = 0;
+    cut.ranges.clear();
+    for (std::string_view r : tokens_by_delims(map, ",;")) {
+        int range[2];
+        const int R = parse_int_range(r, r.find('-') != std::string_view::npos ? "-" : "..", range);
+        if (R == 1) {
+            range[1] = range[0];
+        } else if (R != 2) {
+            cut.valid = false;
+            return;
+        }
+
+        const int a = range[0] - 1;
+        const int b = range[1] - 1;
+        // Ranges starting or ending before the first field are never output
+        if (a < 0 || b < 0) {
+            continue;
+        }
+        cut.ranges.emplace_back(a, b);
+        cut.max_field = std::max(cut.max_field, std::max(a, b) + 1);
+    }
+}
+
+IMPALA_UDF_EXPORT
+void Cut_Paste_Prepare(FunctionContext *context, FunctionContext::FunctionStateScope scope) {
+    if (scope != FunctionContext::FRAGMENT_LOCAL || !context->IsArgConstant(2)) {
+        return;
+    }
+
+    const StringVal *mapVal = reinterpret_cast<const StringVal *>(context->GetConstantArg(2));
+    if (mapVal == NULL || mapVal->is_null) {
+        return;
+    }
+    cut_map_t *cut = new cut_map_t;
+    compile_cut_map(std::string_view((const char *)mapVal->ptr, mapVal->len), *cut);
+    context->SetFunctionState(scope, cut);
+}
+
+IMPALA_UDF_EXPORT
+void Cut_Paste_Close(FunctionContext *context, FunctionContext::FunctionStateScope scope) {
+    if (scope != FunctionContext::FRAGMENT_LOCAL) {
+        return;
+    }
+
+    cut_map_t *cut = reinterpret_cast<cut_map_t *>(context->GetFunctionState(scope));
+    delete cut;
+    context->SetFunctionState(scope, NULL);
+}
+
+// Calls emit for each token selected by the map, skipping ranges that run past the last token
+template <typename Emit>
+inline void for_each_cut_field(
+    const cut_map_t &cut, const std::vector<std::string_view> &tokens, Emit emit
+) {
+    const int L = tokens.size();
+    for (const auto &[a, b] : cut.ranges) {
+        if (a >= L || b >= L) {
+            continue;
+        }
+
+        if (a <= b) {
+            for (int i = a; i <= b; i++) {
+                emit(tokens[i]);
+            }
+        } else {
+            // b < a
+            for (int j = a; j >= b; j--) {
+                emit(tokens[j]);
+            }
+        }
+    }
+}
+
 IMPALA_UDF_EXPORT
 StringVal Cut_Paste(
     FunctionContext *context, const StringVal &my_string, const StringVal &delim,
@@ -1042,7 +1238,6 @@ IMPALA_UDF_EXPORT StringVal Cut_Paste_Output(
 
     std::string_view s((const char *)my_string.ptr, my_string.len);
     std::string_view d((const char *)delim.ptr, delim.len);
-    std::string_view map((const char *)range_map.ptr, range_map.len);
 
     std::string_view od;
     if (out_delim.is_null) {
@@ -1056,59 +1251,55 @@ IMPALA_UDF_EXPORT StringVal Cut_Paste_Output(
         return my_string;
     }
 
-    std::vector<std::string_view> tokens = split_by_substr(s, d);
-    std::vector<std::string_view> ranges = split_by_delims(map, ",;");
-    std::string buffer                   = "";
-    const int L                          = tokens.size();
-
-    for (const auto &r : ranges) {
-        std::vector<int> range;
-        if (r.find("-") != std::string::npos) {
-            range = split_int_by_substr(r, "-");
-        } else {
-            range = split_int_by_substr(r, "..");
-        }
-        const int R = range.size();
-
-        // Multi-value range
-        if (R == 2) {
-            int a = range[0] - 1;
-            int b = range[1] - 1;
-            if (a >= L || a < 0 || b >= L || b < 0) {
-                continue;
-            }
+    // A constant map is compiled once per fragment
+    cut_map_t row_cut;
+    const cut_map_t *cut = reinterpret_cast<const cut_map_t *>(
+        context->GetFunctionState(FunctionContext::FRAGMENT_LOCAL)
+    );
+    if (cut == NULL) {
+        compile_cut_map(std::string_view((const char *)range_map.ptr, range_map.len), row_cut);
+        cut = &row_cut;
+    }
+    if (!cut->valid) {
+        return StringVal::null();
+    }
 
-            if (a <= b) {
-                for (int i = a; i <= b; i++) {
-                    buffer += tokens[i];
-                    buffer += od;
-                }
-            } else {
-                // b < a
-                for (int j = a; j >= b; j--) {
-                    buffer += tokens[j];
-                    buffer += od;
-                }
-            }
-        } else if (R == 1) {
-            const int x = range[0] - 1;
-            if (x >= L || x < 0) {
-                continue;
+    // Fields past the last one requested are never split out
+    std::vector<std::string_view> tokens;
+    if (cut->max_field > 0) {
+        for (std::string_view token : tokens_by_substr(s, d)) {
+            tokens.push_back(token);
+            if (tokens.size() == static_cast<std::size_t>(cut->max_field)) {
+                break;
             }
-
-            buffer += tokens[x];
-            buffer += od;
-        } else {
-            // R == 0 OR R > 2
-            return StringVal::null();
         }
     }
 
-    if (buffer.length() > od.length()) {
-        buffer.erase(buffer.length() - od.length());
+    std::size_t fields = 0;
+    std::size_t length = 0;
+    for_each_cut_field(*cut, tokens, [&](std::string_view token) {
+        fields++;
+        length += token.size();
+    });
+    if (fields > 0) {
+        length += (fields - 1) * od.size();
+    }
+    if (length > StringVal::MAX_LENGTH) {
+        return StringVal::null();
     }
 
-    return to_StringVal(context, buffer);
+    StringVal result(context, length);
+    uint8_t *out = result.ptr;
+    for_each_cut_field(*cut, tokens, [&](std::string_view token) {
+        if (out != result.ptr) {
+            memcpy(out, od.data(), od.size());
+            out += od.size();
+        }
+        memcpy(out, token.data(), token.size());
+        out += token.size();
+    });
+
+    return result;
 }
 
 // Create a mutation list from two aligned strings
@@ -1470,8 +1661,7 @@ StringVal Mutation_List_Strict_GLY(
     return to_StringVal(context, buffer);
 }
 
-IMPALA_UDF_EXPORT
-StringVal Mutation_List_Indel_GLY(
+static StringVal compute_mutation_list_indel_gly(
     FunctionContext *context, const StringVal &seq1_, const StringVal &seq2_
 ) {
     if (seq1_.is_null || seq2_.is_null || seq1_.len == 0 || seq2_.len == 0) {
@@ -1620,6 +1810,13 @@ StringVal Mutation_List_Indel_GLY(
     return StringVal::CopyFrom(context, (const uint8_t *)buffer.c_str(), buffer.size());
 }
 
+IMPALA_UDF_EXPORT
+StringVal Mutation_List_Indel_GLY(
+    FunctionContext *context, const StringVal &seq1_, const StringVal &seq2_
+) {
+    return memoized(context, compute_mutation_list_indel_gly, seq1_, seq2_);
+}
+
 // Create a mutation list from two aligned strings
 // Ignore resolvable ambiguations
 // NT_distance()
@@ -1748,84 +1945,319 @@ IntVal Nt_Distance(
         length = sequence2.len;
     }
 
-    const uint8_t *seq1 = sequence1.ptr;
-    const uint8_t *seq2 = sequence2.ptr;
-
-    int nt_distance = 0;
-    for (std::size_t i = 0; i < length; i++) {
-        nt_distance += NTD[seq1[i]][seq2[i]];
-    }
-
-    return IntVal(nt_distance);
+    return IntVal(nt_distance_bounded(sequence1.ptr, sequence2.ptr, length));
 }
 
+// Reference panel for Nearest_Reference, parsed once per fragment when the panel is constant. A
+// constant panel that cannot be loaded is kept with valid unset so every row returns NULL at once.
+struct ReferencePanel {
+    bool valid = false;
+    std::vector<std::string> names;
+    std::vector<std::string> seqs;
+};
 
-/* Sequence comparison functions */
-IMPALA_UDF_EXPORT
-StringVal Sequence_Diff(FunctionContext *context, const StringVal &seq1, const StringVal &seq2) {
-
-    const StringVal null_stringval = StringVal::null();
-
-    // Check if either StringVal is NULL
-    if (seq1 == null_stringval || seq2 == null_stringval)
-        return StringVal::null();
+// Reads FASTA records into the panel, sequence lines are concatenated with whitespace removed.
+inline bool load_reference_panel_file(const std::string &path, ReferencePanel &panel) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
 
-    // Check if either StringVal is empty.
-    if (seq1.len == 0 || seq2.len == 0)
-        return StringVal::null();
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line[0] == '>') {
+            panel.names.emplace_back(line.substr(1));
+            boost::trim(panel.names.back());
+            panel.seqs.emplace_back();
+        } else if (!panel.seqs.empty()) {
+            boost::remove_erase_if(line, boost::is_any_of("\n\r\t "));
+            panel.seqs.back() += line;
+        }
+    }
 
-    // Declare variables
-    std::string_view seq_ref((const char *)seq1.ptr, seq1.len);
-    std::string_view seq((const char *)seq2.ptr, seq2.len);
-    std::string_view::iterator it_ref, it;
-    std::string diff_seq; // will store difference from ref
+    return true;
+}
 
-    // Iterate through both strings
-    it_ref = seq_ref.begin();
-    it     = seq.begin();
+// The panel is either a path to a local FASTA file (leading '/') or a list of name:sequence
+// entries delimited by semi-colons. Entries without a name or sequence invalidate the panel. Paths
+// are only read when allow_file is set, which is for constant panels loaded once per fragment.
+inline bool load_reference_panel(std::string_view text, ReferencePanel &panel, bool allow_file) {
+    if (text.empty()) {
+        return false;
+    }
 
-    while (it_ref != seq_ref.end() && it != seq.end()) {
+    if (text[0] == '/') {
+        if (!allow_file) {
+            return false;
+        }
+        if (!load_reference_panel_file(std::string(text), panel)) {
+            return false;
+        }
+    } else {
+        for (auto entry : split_by_substr(text, ";")) {
+            std::size_t colon = entry.find(':');
+            if (colon == std::string_view::npos) {
+                return false;
+            }
+            panel.names.emplace_back(entry.substr(0, colon));
+            panel.seqs.emplace_back(entry.substr(colon + 1));
+        }
+    }
 
-        // Compare characters
-        if (toupper(*it_ref) == toupper(*it))
-            diff_seq.push_back('.');
-        else
-            diff_seq.push_back(toupper(*it));
-        it_ref++;
-        it++;
+    for (std::size_t r = 0; r < panel.seqs.size(); r++) {
+        if (panel.names[r].empty() || panel.seqs[r].empty()) {
+            return false;
+        }
     }
-    return StringVal::CopyFrom(context, (const uint8_t *)diff_seq.c_str(), diff_seq.size());
+
+    return !panel.seqs.empty();
 }
 
 IMPALA_UDF_EXPORT
-StringVal Sequence_Diff_NT(FunctionContext *context, const StringVal &seq1, const StringVal &seq2) {
+void Nearest_Reference_Prepare(
+    FunctionContext *context, FunctionContext::FunctionStateScope scope
+) {
+    if (scope != FunctionContext::FRAGMENT_LOCAL || !context->IsArgConstant(1)) {
+        return;
+    }
+
+    const StringVal *panelVal = reinterpret_cast<const StringVal *>(context->GetConstantArg(1));
+    if (panelVal == NULL || panelVal->is_null) {
+        return;
+    }
+
+    ReferencePanel *panel = new ReferencePanel();
+    std::string_view text((const char *)panelVal->ptr, panelVal->len);
+    panel->valid = load_reference_panel(text, *panel, true);
+    if (!panel->valid) {
+        panel->names.clear();
+        panel->seqs.clear();
+    }
+    context->SetFunctionState(scope, panel);
+}
+
+IMPALA_UDF_EXPORT
+void Nearest_Reference_Close(FunctionContext *context, FunctionContext::FunctionStateScope scope) {
+    if (scope != FunctionContext::FRAGMENT_LOCAL) {
+        return;
+    }
+
+    ReferencePanel *panel = reinterpret_cast<ReferencePanel *>(context->GetFunctionState(scope));
+    delete panel;
+    context->SetFunctionState(scope, NULL);
+}
 
-    const StringVal null_stringval = StringVal::null();
+// Returns "name:distance" for the reference with the least Nt_Distance to the sequence. Each
+// reference is abandoned as soon as it can no longer beat the best so far, ties go to the first.
+IMPALA_UDF_EXPORT
+StringVal Nearest_Reference(
+    FunctionContext *context, const StringVal &sequence, const StringVal &panelVal
+) {
+    if (sequence.is_null || panelVal.is_null || sequence.len == 0 || panelVal.len == 0) {
+        return StringVal::null();
+    }
 
-    // Check if either StringVal is NULL
-    if (seq1 == null_stringval || seq2 == null_stringval)
+    const ReferencePanel *panel = reinterpret_cast<const ReferencePanel *>(
+        context->GetFunctionState(FunctionContext::FRAGMENT_LOCAL)
+    );
+
+    // Non-constant panels are parsed per row and cannot name a file
+    ReferencePanel row_panel;
+    if (panel == NULL) {
+        if (!load_reference_panel(
+                std::string_view((const char *)panelVal.ptr, panelVal.len), row_panel, false
+            )) {
+            return StringVal::null();
+        }
+        panel = &row_panel;
+    } else if (!panel->valid) {
         return StringVal::null();
+    }
+
+    std::size_t best_r = 0;
+    int best_d         = std::numeric_limits<int>::max();
+    for (std::size_t r = 0; r < panel->seqs.size() && best_d > 0; r++) {
+        const std::string &ref   = panel->seqs[r];
+        const std::size_t length = std::min(static_cast<std::size_t>(sequence.len), ref.size());
+
+        int d = nt_distance_bounded(sequence.ptr, (const uint8_t *)ref.data(), length, best_d);
+        if (d < best_d) {
+            best_d = d;
+            best_r = r;
+        }
+    }
+
+    std::string result = panel->names[best_r] + ":";
+    append_int(result, best_d);
+    return to_StringVal(context, result);
+}
+
+
+/* Sequence comparison functions */
+
+// Sequence_Diff and Sequence_Diff_NT compare 32 bytes per step with AVX2. Case folding is a signed
+// compare and subtract. The nucleotide masks are looked up with vpshufb by the low nibble in one
+// 16-byte table per high nibble that has nucleotides, folding lower case onto upper case. The
+// tail and non-AVX2 builds use a byte loop, whose restrict pointers let -O3 vectorize it without
+// an alias check.
+
+constexpr uint8_t ascii_upper(uint8_t c) {
+    return c - (static_cast<uint8_t>(c - 'a') < 26 ? 'a' - 'A' : 0);
+}
+
+// NT_IUPAC_MASK of the bytes 0x20-0x2F, 0x40-0x4F and 0x50-0x5F. Bytes 0x60-0x7F share the masks
+// of 0x40-0x5F and all other bytes have none.
+constexpr std::array<std::array<uint8_t, 16>, 3> NT_MASK_ROWS = []() {
+    std::array<std::array<uint8_t, 16>, 3> rows{};
+    for (int i = 0; i < 16; i++) {
+        rows[0][i] = NT_IUPAC_MASK[0x20 + i];
+        rows[1][i] = NT_IUPAC_MASK[0x40 + i];
+        rows[2][i] = NT_IUPAC_MASK[0x50 + i];
+    }
+    return rows;
+}();
+static_assert(
+    []() {
+        for (int c = 0; c < 256; c++) {
+            const int hi  = (c & 0xDF) >> 4;
+            const int row = c >> 4 == 2 ? 0 : (hi == 4 || hi == 5 ? hi - 3 : -1);
+            if (NT_IUPAC_MASK[c] != (row < 0 ? 0 : NT_MASK_ROWS[row][c & 0x0F])) {
+                return false;
+            }
+        }
+        return true;
+    }(),
+    "NT_MASK_ROWS must cover every nucleotide byte"
+);
+
+// Scalar loops for the bytes from `begin` to `end`, the output never overlaps the inputs
+inline void sequence_diff_tail(
+    const uint8_t *__restrict ref, const uint8_t *__restrict seq, uint8_t *__restrict out,
+    std::size_t begin, std::size_t end
+) {
+    for (std::size_t i = begin; i < end; i++) {
+        const uint8_t r = ascii_upper(ref[i]);
+        const uint8_t q = ascii_upper(seq[i]);
+        out[i]          = r == q ? '.' : q;
+    }
+}
+
+inline void sequence_diff_nt_tail(
+    const uint8_t *__restrict ref, const uint8_t *__restrict seq, uint8_t *__restrict out,
+    std::size_t begin, std::size_t end
+) {
+    for (std::size_t i = begin; i < end; i++) {
+        const uint8_t r     = NT_IUPAC_MASK[ref[i]];
+        const uint8_t q     = NT_IUPAC_MASK[seq[i]];
+        const uint8_t inter = r & q;
+        const uint8_t equal = inter == r || inter == q;
+        out[i]              = (r == 0 || q == 0) ? '?' : (equal ? '.' : seq[i]);
+    }
+}
+
+#ifdef __AVX2__
+inline __m256i load_diff_bytes(const uint8_t *p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+inline __m256i ascii_upper_vector(__m256i v) {
+    // c - 'a' < 26 as a signed compare after moving 'a' to -128
+    const __m256i shifted = _mm256_add_epi8(v, _mm256_set1_epi8(static_cast<char>(0x80 - 'a')));
+    const __m256i lower   = _mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 26), shifted);
+    return _mm256_sub_epi8(v, _mm256_and_si256(lower, _mm256_set1_epi8('a' - 'A')));
+}
+
+inline __m256i nt_iupac_mask_vector(__m256i v) {
+    auto row = [](int r) {
+        const auto *bytes = reinterpret_cast<const __m128i *>(NT_MASK_ROWS[r].data());
+        return _mm256_broadcastsi128_si256(_mm_loadu_si128(bytes));
+    };
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i lo     = _mm256_and_si256(v, nibble);
+    const __m256i hi     = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+    const __m256i folded = _mm256_and_si256(hi, _mm256_set1_epi8(0x0D));
+
+    __m256i mask = _mm256_and_si256(
+        _mm256_shuffle_epi8(row(0), lo), _mm256_cmpeq_epi8(hi, _mm256_set1_epi8(2))
+    );
+    const __m256i upper = _mm256_and_si256(
+        _mm256_shuffle_epi8(row(1), lo), _mm256_cmpeq_epi8(folded, _mm256_set1_epi8(4))
+    );
+    const __m256i upper_next = _mm256_and_si256(
+        _mm256_shuffle_epi8(row(2), lo), _mm256_cmpeq_epi8(folded, _mm256_set1_epi8(5))
+    );
+    return _mm256_or_si256(mask, _mm256_or_si256(upper, upper_next));
+}
+#endif
 
-    // Check if either StringVal is empty.
-    if (seq1.len == 0 || seq2.len == 0)
+IMPALA_UDF_EXPORT
+StringVal Sequence_Diff(FunctionContext *context, const StringVal &seq1, const StringVal &seq2) {
+    if (seq1.is_null || seq2.is_null || seq1.len == 0 || seq2.len == 0) {
         return StringVal::null();
+    }
+
+    const std::size_t length = std::min(seq1.len, seq2.len);
+    StringVal result(context, length);
+    if (result.is_null) {
+        return result;
+    }
 
-    // Declare variables
-    std::string_view seq_ref((const char *)seq1.ptr, seq1.len);
-    std::string_view seq((const char *)seq2.ptr, seq2.len);
-    std::string_view::iterator it_ref, it;
-    std::string diff_seq; // will store difference from ref
+    const uint8_t *ref = seq1.ptr;
+    const uint8_t *seq = seq2.ptr;
+    uint8_t *out       = result.ptr;
+    std::size_t i      = 0;
+#ifdef __AVX2__
+    const __m256i dot = _mm256_set1_epi8('.');
+    for (; i + 32 <= length; i += 32) {
+        const __m256i r = ascii_upper_vector(load_diff_bytes(ref + i));
+        const __m256i q = ascii_upper_vector(load_diff_bytes(seq + i));
+        const __m256i d = _mm256_blendv_epi8(q, dot, _mm256_cmpeq_epi8(r, q));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), d);
+    }
+#endif
+    sequence_diff_tail(ref, seq, out, i, length);
+
+    return result;
+}
 
-    // Iterate through both strings
-    it_ref = seq_ref.begin();
-    it     = seq.begin();
+IMPALA_UDF_EXPORT
+StringVal Sequence_Diff_NT(FunctionContext *context, const StringVal &seq1, const StringVal &seq2) {
+    if (seq1.is_null || seq2.is_null || seq1.len == 0 || seq2.len == 0) {
+        return StringVal::null();
+    }
 
-    while (it_ref != seq_ref.end() && it != seq.end()) {
-        diff_seq.push_back(NT_DIFF[*it_ref][*it]);
-        it_ref++;
-        it++;
+    const std::size_t length = std::min(seq1.len, seq2.len);
+    StringVal result(context, length);
+    if (result.is_null) {
+        return result;
     }
-    return StringVal::CopyFrom(context, (const uint8_t *)diff_seq.c_str(), diff_seq.size());
+
+    // Non-nucleotides give '?', resolvably equal nucleotides give '.', otherwise the seq2 byte
+    const uint8_t *ref = seq1.ptr;
+    const uint8_t *seq = seq2.ptr;
+    uint8_t *out       = result.ptr;
+    std::size_t i      = 0;
+#ifdef __AVX2__
+    const __m256i dot      = _mm256_set1_epi8('.');
+    const __m256i question = _mm256_set1_epi8('?');
+    const __m256i zero     = _mm256_setzero_si256();
+    for (; i + 32 <= length; i += 32) {
+        const __m256i bytes = load_diff_bytes(seq + i);
+        const __m256i r     = nt_iupac_mask_vector(load_diff_bytes(ref + i));
+        const __m256i q     = nt_iupac_mask_vector(bytes);
+        const __m256i inter = _mm256_and_si256(r, q);
+        const __m256i equal =
+            _mm256_or_si256(_mm256_cmpeq_epi8(inter, r), _mm256_cmpeq_epi8(inter, q));
+        const __m256i invalid =
+            _mm256_or_si256(_mm256_cmpeq_epi8(r, zero), _mm256_cmpeq_epi8(q, zero));
+        const __m256i diff = _mm256_blendv_epi8(bytes, dot, equal);
+        const __m256i d    = _mm256_blendv_epi8(diff, question, invalid);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), d);
+    }
+#endif
+    sequence_diff_nt_tail(ref, seq, out, i, length);
+
+    return result;
 }
 
 IMPALA_UDF_EXPORT
@@ -1903,6 +2335,48 @@ StringVal Physiochemical_Distance_List(
     return to_StringVal(context, result);
 }
 
+// A constant list and delimiter are compiled once into an automaton over all of the elements, or
+// into a byte set when the empty delimiter splits the list by character
+struct ElementMatcher {
+    std::unique_ptr<AhoCorasick> elements;
+    std::unique_ptr<ByteSet> characters;
+};
+
+IMPALA_UDF_EXPORT
+void Contains_Element_Prepare(FunctionContext *context, FunctionContext::FunctionStateScope scope) {
+    if (scope != FunctionContext::FRAGMENT_LOCAL || !context->IsArgConstant(1) ||
+        !context->IsArgConstant(2)) {
+        return;
+    }
+
+    const StringVal *listVal  = reinterpret_cast<const StringVal *>(context->GetConstantArg(1));
+    const StringVal *delimVal = reinterpret_cast<const StringVal *>(context->GetConstantArg(2));
+    if (listVal == NULL || delimVal == NULL || listVal->is_null || delimVal->is_null) {
+        return;
+    }
+
+    std::string_view list((const char *)listVal->ptr, listVal->len);
+    std::string_view delim((const char *)delimVal->ptr, delimVal->len);
+    ElementMatcher *matcher = new ElementMatcher;
+    if (delim.empty()) {
+        matcher->characters = std::make_unique<ByteSet>(list);
+    } else {
+        matcher->elements = std::make_unique<AhoCorasick>(tokens_by_substr(list, delim));
+    }
+    context->SetFunctionState(scope, matcher);
+}
+
+IMPALA_UDF_EXPORT
+void Contains_Element_Close(FunctionContext *context, FunctionContext::FunctionStateScope scope) {
+    if (scope != FunctionContext::FRAGMENT_LOCAL) {
+        return;
+    }
+
+    ElementMatcher *matcher = reinterpret_cast<ElementMatcher *>(context->GetFunctionState(scope));
+    delete matcher;
+    context->SetFunctionState(scope, NULL);
+}
+
 IMPALA_UDF_EXPORT
 BooleanVal Contains_An_Element(
     FunctionContext *context, const StringVal &mystring, const StringVal &list_of_items,
@@ -1913,25 +2387,26 @@ BooleanVal Contains_An_Element(
     }
     if (mystring.len == 0 || list_of_items.len == 0) {
         return BooleanVal(false);
-    } else if (delimVal.len == 0) {
-        std::string haystack((const char *)mystring.ptr, mystring.len);
-        std::string needles((const char *)list_of_items.ptr, list_of_items.len);
-        return BooleanVal(haystack.find_first_of(needles) != std::string::npos);
     }
 
-    std::string s1((const char *)mystring.ptr, mystring.len);
-    std::string s2((const char *)list_of_items.ptr, list_of_items.len);
-    std::string delim((const char *)delimVal.ptr, delimVal.len);
-    std::vector<std::string> tokens = split_by_substr(s2, delim);
-
-    // if the delim = string, then of course nothing can be found
-    if (tokens.size() == 0) {
-        return BooleanVal(false);
+    std::string_view s1((const char *)mystring.ptr, mystring.len);
+    std::string_view s2((const char *)list_of_items.ptr, list_of_items.len);
+    const ElementMatcher *matcher = reinterpret_cast<const ElementMatcher *>(
+        context->GetFunctionState(FunctionContext::FRAGMENT_LOCAL)
+    );
+    if (matcher != NULL) {
+        return BooleanVal(
+            matcher->elements ? matcher->elements->search(s1) : matcher->characters->search(s1)
+        );
+    } else if (delimVal.len == 0) {
+        return BooleanVal(ByteSet(s2).search(s1));
     }
 
-    // otherwise search for the element
-    for (std::vector<std::string>::const_iterator i = tokens.begin(); i < tokens.end(); ++i) {
-        if (s1.find(*i) != std::string::npos && (*i).length() > 0) {
+    std::string_view delim((const char *)delimVal.ptr, delimVal.len);
+
+    // search for each element, stopping at the first found
+    for (std::string_view token : tokens_by_substr(s2, delim)) {
+        if (s1.find(token) != std::string_view::npos) {
             return BooleanVal(true);
         }
     }
@@ -1940,6 +2415,37 @@ BooleanVal Contains_An_Element(
     return BooleanVal(false);
 }
 
+// A constant list and delimiter are indexed once into a hash set of the elements
+IMPALA_UDF_EXPORT
+void Is_Element_Prepare(FunctionContext *context, FunctionContext::FunctionStateScope scope) {
+    if (scope != FunctionContext::FRAGMENT_LOCAL || !context->IsArgConstant(1) ||
+        !context->IsArgConstant(2)) {
+        return;
+    }
+
+    const StringVal *listVal  = reinterpret_cast<const StringVal *>(context->GetConstantArg(1));
+    const StringVal *delimVal = reinterpret_cast<const StringVal *>(context->GetConstantArg(2));
+    if (listVal == NULL || delimVal == NULL || listVal->is_null || delimVal->is_null ||
+        delimVal->len == 0) {
+        return;
+    }
+
+    std::string_view list((const char *)listVal->ptr, listVal->len);
+    std::string_view delim((const char *)delimVal->ptr, delimVal->len);
+    context->SetFunctionState(scope, new StringSet(tokens_by_substr(list, delim)));
+}
+
+IMPALA_UDF_EXPORT
+void Is_Element_Close(FunctionContext *context, FunctionContext::FunctionStateScope scope) {
+    if (scope != FunctionContext::FRAGMENT_LOCAL) {
+        return;
+    }
+
+    StringSet *elements = reinterpret_cast<StringSet *>(context->GetFunctionState(scope));
+    delete elements;
+    context->SetFunctionState(scope, NULL);
+}
+
 IMPALA_UDF_EXPORT
 BooleanVal Is_An_Element(
     FunctionContext *context, const StringVal &needle, const StringVal &list_of_items,
@@ -1954,16 +2460,19 @@ BooleanVal Is_An_Element(
         return character_in_string(needle, list_of_items);
     }
 
-    std::string s1((const char *)needle.ptr, needle.len);
-    std::string s2((const char *)list_of_items.ptr, list_of_items.len);
-    std::string delim((const char *)delimVal.ptr, delimVal.len);
-    std::vector<std::string> tokens = split_by_substr(s2, delim);
-
-    if (tokens.size() == 0) {
-        return BooleanVal(false);
+    std::string_view s1((const char *)needle.ptr, needle.len);
+    const StringSet *elements = reinterpret_cast<const StringSet *>(
+        context->GetFunctionState(FunctionContext::FRAGMENT_LOCAL)
+    );
+    if (elements != NULL) {
+        return BooleanVal(elements->contains(s1));
     }
-    for (std::vector<std::string>::const_iterator i = tokens.begin(); i < tokens.end(); ++i) {
-        if (s1 == (*i) && (*i).length() > 0) {
+
+    std::string_view s2((const char *)list_of_items.ptr, list_of_items.len);
+    std::string_view delim((const char *)delimVal.ptr, delimVal.len);
+
+    for (std::string_view token : tokens_by_substr(s2, delim)) {
+        if (s1 == token) {
             return BooleanVal(true);
         }
     }
@@ -1981,119 +2490,425 @@ BooleanVal Contains_Symmetric(
         return BooleanVal(false);
     }
 
-    std::string s1((const char *)string1.ptr, string1.len);
-    std::string s2((const char *)string2.ptr, string2.len);
+    // Only the shorter string can be found in the longer one
+    const StringVal &shorter = string1.len <= string2.len ? string1 : string2;
+    const StringVal &longer  = string1.len <= string2.len ? string2 : string1;
+    return BooleanVal(contains_substring<false>(longer.ptr, longer.len, shorter.ptr, shorter.len));
+}
 
-    if (s1.find(s2) != std::string::npos || s2.find(s1) != std::string::npos) {
-        return BooleanVal(true);
-    } else {
+IMPALA_UDF_EXPORT
+BooleanVal Contains_Symmetric_Ignore_Case(
+    FunctionContext *context, const StringVal &string1, const StringVal &string2
+) {
+    if (string1.is_null || string2.is_null) {
+        return BooleanVal::null();
+    }
+    if ((string1.len == 0) != (string2.len == 0)) {
         return BooleanVal(false);
     }
+
+    const StringVal &shorter = string1.len <= string2.len ? string1 : string2;
+    const StringVal &longer  = string1.len <= string2.len ? string2 : string1;
+    return BooleanVal(contains_substring<true>(longer.ptr, longer.len, shorter.ptr, shorter.len));
+}
+
+// Sequence standardization as a table: each byte is kept (upper-cased) or dropped. Hashing streams
+// the kept bytes through a small stack chunk instead of building a cleaned copy of the sequence.
+struct SeqStdTable {
+    std::array<uint8_t, 256> upper;
+    std::array<uint8_t, 256> keep;
+};
+
+constexpr SeqStdTable make_seq_std_table(std::string_view drop) {
+    SeqStdTable t{};
+    for (int c = 0; c < 256; c++) {
+        t.upper[c] = ascii_upper(c);
+        t.keep[c]  = drop.find(static_cast<char>(c)) == std::string_view::npos;
+    }
+    return t;
+}
+
+constexpr SeqStdTable NT_STD_TABLE = make_seq_std_table("\n\r\t :.~-");
+constexpr SeqStdTable AA_STD_TABLE = make_seq_std_table("\n\r\t :.-");
+
+const std::size_t STD_HASH_CHUNK = 4096;
+const std::size_t STD_BLOCK      = 64;
+
+constexpr uint8_t ascii_is_letter(uint8_t c) { return static_cast<uint8_t>((c | 0x20) - 'a') < 26; }
+
+// Writes the standardized bytes of src to out, which must hold len bytes, and returns how many were
+// kept. Letters are always kept, so whole blocks made only of letters are copied and upper-cased in
+// bulk (both loops have a fixed trip count so they vectorize at -O2). Other bytes go one at a time,
+// with dropped bytes written and then overwritten to keep the loop free of branches.
+inline std::size_t std_compact(
+    const uint8_t *src, std::size_t len, const SeqStdTable &table, uint8_t *out
+) {
+    std::size_t n = 0;
+    std::size_t i = 0;
+    for (; i + STD_BLOCK <= len; i += STD_BLOCK) {
+        const uint8_t *block = src + i;
+        uint8_t letters      = 1;
+        for (std::size_t k = 0; k < STD_BLOCK; k++) {
+            letters &= ascii_is_letter(block[k]);
+        }
+
+        if (letters) {
+            uint8_t *dest = out + n;
+            memcpy(dest, block, STD_BLOCK);
+            for (std::size_t k = 0; k < STD_BLOCK; k++) {
+                dest[k] = ascii_upper(dest[k]);
+            }
+            n += STD_BLOCK;
+        } else {
+            for (std::size_t k = 0; k < STD_BLOCK; k++) {
+                out[n] = table.upper[block[k]];
+                n += table.keep[block[k]];
+            }
+        }
+    }
+
+    for (; i < len; i++) {
+        out[n] = table.upper[src[i]];
+        n += table.keep[src[i]];
+    }
+    return n;
+}
+
+// Feeds the standardized sequence to update(data, len) one chunk at a time
+template <typename F>
+inline void std_stream(const StringVal &sequence, const SeqStdTable &table, F &&update) {
+    uint8_t chunk[STD_HASH_CHUNK];
+    const std::size_t len = sequence.len;
+    for (std::size_t i = 0; i < len; i += STD_HASH_CHUNK) {
+        const std::size_t n =
+            std_compact(sequence.ptr + i, std::min(STD_HASH_CHUNK, len - i), table, chunk);
+        if (n > 0) {
+            update(chunk, n);
+        }
+    }
+}
+
+// Standardizes into a result allocated at the input length, then shrunk to the bytes kept
+inline StringVal std_string(
+    FunctionContext *context, const StringVal &sequence, const SeqStdTable &table
+) {
+    if (sequence.is_null || sequence.len == 0) {
+        return StringVal::null();
+    }
+
+    StringVal result(context, sequence.len);
+    if (result.is_null) {
+        return result;
+    }
+    result.len = std_compact(sequence.ptr, sequence.len, table, result.ptr);
+    return result;
+}
+
+// Lower-case hexadecimal of a digest, written directly into the result
+inline StringVal digest_to_hex(FunctionContext *context, const unsigned char *digest, int n) {
+    constexpr unsigned char HEX[17] = "0123456789abcdef";
+
+    StringVal hash(context, 2 * n);
+    if (hash.is_null) {
+        return hash;
+    }
+    for (int j = 0; j < n; j++) {
+        hash.ptr[2 * j]     = HEX[(digest[j] >> 4) & 0x0F];
+        hash.ptr[2 * j + 1] = HEX[digest[j] & 0x0F];
+    }
+    return hash;
+}
+
+static StringVal compute_nt_id(FunctionContext *context, const StringVal &sequence) {
+    if (sequence.is_null || sequence.len == 0) {
+        return StringVal::null();
+    }
+
+    SHA_CTX ctx;
+    SHA1_Init(&ctx);
+    std_stream(sequence, NT_STD_TABLE, [&](const uint8_t *data, std::size_t n) {
+        SHA1_Update(&ctx, data, n);
+    });
+
+    unsigned char obuf[SHA_DIGEST_LENGTH];
+    SHA1_Final(obuf, &ctx);
+    return digest_to_hex(context, obuf, SHA_DIGEST_LENGTH);
 }
 
 IMPALA_UDF_EXPORT
 StringVal nt_id(FunctionContext *context, const StringVal &sequence) {
+    return memoized(context, compute_nt_id, sequence);
+}
+
+IMPALA_UDF_EXPORT
+StringVal nt_std(FunctionContext *context, const StringVal &sequence) {
+    return std_string(context, sequence, NT_STD_TABLE);
+}
+
+IMPALA_UDF_EXPORT
+StringVal aa_std(FunctionContext *context, const StringVal &sequence) {
+    return std_string(context, sequence, AA_STD_TABLE);
+}
+
+static StringVal compute_variant_hash(FunctionContext *context, const StringVal &sequence) {
     if (sequence.is_null || sequence.len == 0) {
         return StringVal::null();
     }
-    std::string seq((const char *)sequence.ptr, sequence.len);
-    boost::remove_erase_if(seq, boost::is_any_of("\n\r\t :.~-"));
-    boost::to_upper(seq);
 
-    unsigned char obuf[21];
-    SHA1((const unsigned char *)seq.c_str(), seq.size(), obuf);
+    MD5_CTX ctx;
+    MD5_Init(&ctx);
+    std_stream(sequence, AA_STD_TABLE, [&](const uint8_t *data, std::size_t n) {
+        MD5_Update(&ctx, data, n);
+    });
+
+    unsigned char obuf[MD5_DIGEST_LENGTH];
+    MD5_Final(obuf, &ctx);
+    return digest_to_hex(context, obuf, MD5_DIGEST_LENGTH);
+}
+
+IMPALA_UDF_EXPORT
+StringVal variant_hash(FunctionContext *context, const StringVal &sequence) {
+    return memoized(context, compute_variant_hash, sequence);
+}
+
+// Standardizes the sequences and hashes them with the multi-buffer engine, a group of about
+// STD_BATCH_BYTES at a time so that the shared buffer stays in cache. Empty sequences, for which
+// the UDFs return NULL, give empty strings.
+const std::size_t STD_BATCH_BYTES = 1 << 20;
+
+template <typename Hash>
+static std::vector<std::string> std_hash_batch(
+    const std::vector<std::string_view> &sequences, const SeqStdTable &table
+) {
+    constexpr char HEX[17] = "0123456789abcdef";
+
+    std::vector<std::string> ids(sequences.size());
+    std::string buffer;
+    std::vector<std::size_t> ends;
+    std::vector<std::string_view> messages;
+    std::vector<uint8_t> digests;
+
+    for (std::size_t first = 0, last = 0; first < sequences.size(); first = last) {
+        buffer.clear();
+        ends.clear();
+        for (last = first; last < sequences.size(); last++) {
+            if (last > first && buffer.size() + sequences[last].size() > STD_BATCH_BYTES) {
+                break;
+            }
+            const StringVal sequence((uint8_t *)sequences[last].data(), sequences[last].size());
+            std_stream(sequence, table, [&](const uint8_t *data, std::size_t n) {
+                buffer.append((const char *)data, n);
+            });
+            ends.push_back(buffer.size());
+        }
+
+        messages.resize(ends.size());
+        for (std::size_t i = 0; i < ends.size(); i++) {
+            const std::size_t start = i == 0 ? 0 : ends[i - 1];
+            messages[i]             = std::string_view(buffer.data() + start, ends[i] - start);
+        }
+        digests.resize(ends.size() * Hash::DIGEST_BYTES);
+        multibuffer_hash<Hash>(messages, digests.data());
 
-    char buffer[42 * sizeof(char)];
-    int j;
-    for (j = 0; j < 20; j++) {
-        sprintf(&buffer[2 * j * sizeof(char)], "%02x", obuf[j]);
+        for (std::size_t i = first; i < last; i++) {
+            if (sequences[i].empty()) {
+                continue;
+            }
+            const uint8_t *digest = digests.data() + (i - first) * Hash::DIGEST_BYTES;
+            ids[i].resize(2 * Hash::DIGEST_BYTES);
+            for (std::size_t j = 0; j < Hash::DIGEST_BYTES; j++) {
+                ids[i][2 * j]     = HEX[(digest[j] >> 4) & 0x0F];
+                ids[i][2 * j + 1] = HEX[digest[j] & 0x0F];
+            }
+        }
     }
+    return ids;
+}
 
-    return to_StringVal(context, buffer);
+// Batched nt_id for callers outside of Impala, such as re-identifying an archive
+IMPALA_UDF_EXPORT
+std::vector<std::string> nt_id_batch(const std::vector<std::string_view> &sequences) {
+    return std_hash_batch<MultiSHA1>(sequences, NT_STD_TABLE);
 }
 
+// Batched variant_hash for callers outside of Impala
 IMPALA_UDF_EXPORT
-StringVal nt_std(FunctionContext *context, const StringVal &sequence) {
+std::vector<std::string> variant_hash_batch(const std::vector<std::string_view> &sequences) {
+    return std_hash_batch<MultiMD5>(sequences, AA_STD_TABLE);
+}
+
+// 128-bit fingerprint of the standardized sequence as (high, low)
+inline std::pair<uint64_t, uint64_t> std_fingerprint(
+    const StringVal &sequence, const SeqStdTable &table
+) {
+    Fingerprint128 fp;
+    std_stream(sequence, table, [&](const uint8_t *data, std::size_t n) { fp.update(data, n); });
+    return fp.digest();
+}
+
+inline StringVal fingerprint_to_hex(FunctionContext *context, std::pair<uint64_t, uint64_t> fp) {
+    unsigned char digest[16];
+    for (int j = 0; j < 8; j++) {
+        digest[j]     = fp.first >> (56 - 8 * j);
+        digest[j + 8] = fp.second >> (56 - 8 * j);
+    }
+    return digest_to_hex(context, digest, 16);
+}
+
+IMPALA_UDF_EXPORT
+StringVal nt_fingerprint(FunctionContext *context, const StringVal &sequence) {
     if (sequence.is_null || sequence.len == 0) {
         return StringVal::null();
     }
-    std::string seq((const char *)sequence.ptr, sequence.len);
-    boost::remove_erase_if(seq, boost::is_any_of("\n\r\t :.~-"));
-    boost::to_upper(seq);
+    return fingerprint_to_hex(context, std_fingerprint(sequence, NT_STD_TABLE));
+}
 
-    return to_StringVal(context, seq);
+IMPALA_UDF_EXPORT
+BigIntVal nt_fingerprint_hi(FunctionContext *context, const StringVal &sequence) {
+    if (sequence.is_null || sequence.len == 0) {
+        return BigIntVal::null();
+    }
+    return BigIntVal(static_cast<int64_t>(std_fingerprint(sequence, NT_STD_TABLE).first));
 }
 
 IMPALA_UDF_EXPORT
-StringVal aa_std(FunctionContext *context, const StringVal &sequence) {
+BigIntVal nt_fingerprint_lo(FunctionContext *context, const StringVal &sequence) {
+    if (sequence.is_null || sequence.len == 0) {
+        return BigIntVal::null();
+    }
+    return BigIntVal(static_cast<int64_t>(std_fingerprint(sequence, NT_STD_TABLE).second));
+}
+
+IMPALA_UDF_EXPORT
+StringVal aa_fingerprint(FunctionContext *context, const StringVal &sequence) {
     if (sequence.is_null || sequence.len == 0) {
         return StringVal::null();
     }
-    std::string seq((const char *)sequence.ptr, sequence.len);
-    boost::remove_erase_if(seq, boost::is_any_of("\n\r\t :.-"));
-    boost::to_upper(seq);
+    return fingerprint_to_hex(context, std_fingerprint(sequence, AA_STD_TABLE));
+}
 
-    return to_StringVal(context, seq);
+IMPALA_UDF_EXPORT
+BigIntVal aa_fingerprint_hi(FunctionContext *context, const StringVal &sequence) {
+    if (sequence.is_null || sequence.len == 0) {
+        return BigIntVal::null();
+    }
+    return BigIntVal(static_cast<int64_t>(std_fingerprint(sequence, AA_STD_TABLE).first));
 }
 
 IMPALA_UDF_EXPORT
-StringVal variant_hash(FunctionContext *context, const StringVal &sequence) {
+BigIntVal aa_fingerprint_lo(FunctionContext *context, const StringVal &sequence) {
     if (sequence.is_null || sequence.len == 0) {
+        return BigIntVal::null();
+    }
+    return BigIntVal(static_cast<int64_t>(std_fingerprint(sequence, AA_STD_TABLE).second));
+}
+
+IMPALA_UDF_EXPORT
+StringVal Nt_Sketch_K_S(
+    FunctionContext *context, const StringVal &sequence, const IntVal &kVal, const IntVal &sVal
+) {
+    if (sequence.is_null || sequence.len == 0 || kVal.is_null || sVal.is_null) {
+        return StringVal::null();
+    }
+    if (kVal.val < 1 || kVal.val > SKETCH_MAX_K || sVal.val < 1) {
+        return StringVal::null();
+    }
+
+    std::vector<uint64_t> hashes = sketch_kmers(sequence.ptr, sequence.len, kVal.val, sVal.val);
+    if (hashes.empty()) {
         return StringVal::null();
     }
-    std::string seq((const char *)sequence.ptr, sequence.len);
-    boost::remove_erase_if(seq, boost::is_any_of("\n\r\t :.-"));
-    boost::to_upper(seq);
 
-    unsigned char obuf[17];
-    MD5((const unsigned char *)seq.c_str(), seq.size(), obuf);
+    StringVal result(context, sketch_bytes(hashes.size()));
+    if (result.is_null) {
+        return StringVal::null();
+    }
+    write_sketch(result.ptr, kVal.val, sVal.val, hashes);
+    return result;
+}
 
-    char buffer[34 * sizeof(char)];
-    int j;
-    for (j = 0; j < 16; j++) {
-        sprintf(&buffer[2 * j * sizeof(char)], "%02x", obuf[j]);
+IMPALA_UDF_EXPORT
+StringVal Nt_Sketch(FunctionContext *context, const StringVal &sequence) {
+    return Nt_Sketch_K_S(
+        context, sequence, IntVal(SKETCH_DEFAULT_K), IntVal(static_cast<int>(SKETCH_DEFAULT_S))
+    );
+}
+
+// Estimated Jaccard index of two sketches with the same k, or -1 if they cannot be compared
+static double sketch_jaccard(const StringVal &sketch1, const StringVal &sketch2, uint8_t &k) {
+    SketchView a;
+    SketchView b;
+    if (!sketch_view(sketch1, a) || !sketch_view(sketch2, b) || a.k != b.k) {
+        return -1;
     }
 
-    return to_StringVal(context, buffer);
+    uint32_t shared                = 0;
+    std::vector<uint64_t> in_union = sketch_union(a, b, std::min(a.s, b.s), shared);
+    if (in_union.empty()) {
+        return -1;
+    }
+
+    k = a.k;
+    return static_cast<double>(shared) / in_union.size();
+}
+
+IMPALA_UDF_EXPORT
+DoubleVal Sketch_Similarity(
+    FunctionContext *context, const StringVal &sketch1, const StringVal &sketch2
+) {
+    uint8_t k      = 0;
+    double jaccard = sketch_jaccard(sketch1, sketch2, k);
+    if (jaccard < 0) {
+        return DoubleVal::null();
+    }
+    return DoubleVal(jaccard);
+}
+
+// Mash distance (Ondov et al. 2016), capped at 1 for sketches sharing no k-mers
+IMPALA_UDF_EXPORT
+DoubleVal Sketch_Distance(
+    FunctionContext *context, const StringVal &sketch1, const StringVal &sketch2
+) {
+    uint8_t k      = 0;
+    double jaccard = sketch_jaccard(sketch1, sketch2, k);
+    if (jaccard < 0) {
+        return DoubleVal::null();
+    } else if (jaccard == 0) {
+        return DoubleVal(1.0);
+    }
+    return DoubleVal(-std::log(2 * jaccard / (1 + jaccard)) / k);
 }
 
+// Fields are hashed as if joined by the bell character, streaming each one into the digest
 IMPALA_UDF_EXPORT
 StringVal md5(FunctionContext *context, int num_vars, const StringVal *args) {
-    if (num_vars == 0 || args[0].is_null) {
+    if (num_vars == 0) {
         return StringVal::null();
     }
 
-    std::string input((const char *)args[0].ptr, args[0].len);
-    const char delim = '\a';
-    for (int i = 1; i < num_vars; i++) {
+    std::size_t length = num_vars - 1;
+    for (int i = 0; i < num_vars; i++) {
         if (args[i].is_null) {
             return StringVal::null();
-        } else if (args[i].len == 0) {
-            input += delim;
-        } else {
-            std::string_view next_var((const char *)args[i].ptr, args[i].len);
-            input += delim;
-            input += next_var;
         }
+        length += args[i].len;
     }
-    if (input.size() == 0) {
+    if (length == 0) {
         return StringVal::null();
     }
 
-    unsigned char obuf[17];
-    MD5((const unsigned char *)input.c_str(), input.size(), obuf);
-
-    StringVal hash(context, 32);
-    // Courtesy:
-    // https://stackoverflow.com/questions/6357031/how-do-you-convert-a-byte-array-to-a-hexadecimal-string-in-c/17147874#17147874
-    constexpr unsigned char HEX[17] = "0123456789abcdef";
-    auto *p                         = hash.ptr;
-    for (int j = 0; j < 16; j++) {
-        hash.ptr[2 * j]     = HEX[(obuf[j] >> 4) & 0x0F];
-        hash.ptr[2 * j + 1] = HEX[(obuf[j]) & 0x0F];
+    const unsigned char delim = '\a';
+    MD5_CTX ctx;
+    MD5_Init(&ctx);
+    MD5_Update(&ctx, args[0].ptr, args[0].len);
+    for (int i = 1; i < num_vars; i++) {
+        MD5_Update(&ctx, &delim, 1);
+        MD5_Update(&ctx, args[i].ptr, args[i].len);
     }
 
-    return hash;
+    unsigned char obuf[MD5_DIGEST_LENGTH];
+    MD5_Final(obuf, &ctx);
+    return digest_to_hex(context, obuf, MD5_DIGEST_LENGTH);
 }
 
 IMPALA_UDF_EXPORT
@@ -2189,12 +3004,9 @@ DoubleVal Calculate_Entropy(FunctionContext *context, const StringVal &s) {
     return DoubleVal(ent_sum);
 }
 
-inline std::array<double, 7> Tn_93_Variables(const StringVal &seq1, const StringVal &seq2) {
-    std::string sequence1((const char *)seq1.ptr, seq1.len);
-    std::string sequence2((const char *)seq2.ptr, seq2.len);
-
-    auto matrix = buildSubMatrix(sequence1, sequence2);
-
+inline std::array<double, 7> Tn_93_Matrix_Variables(
+    const std::array<std::array<unsigned int, 4>, 4> &matrix
+) {
     // base frequencies
     std::array<double, 4> bf = {0.0, 0.0, 0.0, 0.0};
     int total_bases          = 0;
@@ -2240,6 +3052,13 @@ inline std::array<double, 7> Tn_93_Variables(const StringVal &seq1, const String
     return {k1, k2, k3, k4, w1, w2, w3};
 }
 
+inline std::array<double, 7> Tn_93_Variables(const StringVal &seq1, const StringVal &seq2) {
+    std::string sequence1((const char *)seq1.ptr, seq1.len);
+    std::string sequence2((const char *)seq2.ptr, seq2.len);
+
+    return Tn_93_Matrix_Variables(buildSubMatrix(sequence1, sequence2));
+}
+
 IMPALA_UDF_EXPORT
 DoubleVal Tn_93_Distance(FunctionContext *context, const StringVal &seq1, const StringVal &seq2) {
 
@@ -2277,4 +3096,453 @@ DoubleVal Tn_93_Gamma(
     }
 
     return DoubleVal(dist);
-}
\ No newline at end of file
+}
+
+/* Packed nucleotide functions */
+IMPALA_UDF_EXPORT
+StringVal NT_Pack_Bits(FunctionContext *context, const StringVal &sequence, const IntVal &bits) {
+    if (sequence.is_null || sequence.len == 0 || bits.is_null || (bits.val != 2 && bits.val != 4)) {
+        return StringVal::null();
+    }
+
+    const auto &to_code = bits.val == 4 ? TO_NT4 : TO_NT2;
+    const std::size_t n = sequence.len;
+
+    uint32_t n_exceptions = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        n_exceptions += to_code[sequence.ptr[i]] == PACKED_NO_CODE;
+    }
+
+    const std::size_t data_bytes = packed_data_bytes(bits.val, n);
+    const std::size_t total      = PACKED_HEADER + data_bytes + PACKED_EXCEPTION * n_exceptions;
+    if (total > StringVal::MAX_LENGTH) {
+        return StringVal::null();
+    }
+
+    StringVal result(context, total);
+    if (result.is_null) {
+        return result;
+    }
+
+    const uint32_t sites = n;
+    result.ptr[0]        = bits.val;
+    memcpy(result.ptr + 1, &sites, sizeof(uint32_t));
+    memcpy(result.ptr + 5, &n_exceptions, sizeof(uint32_t));
+
+    uint8_t *data      = result.ptr + PACKED_HEADER;
+    uint8_t *exception = data + data_bytes;
+    memset(data, 0, data_bytes);
+    for (std::size_t i = 0; i < n; i++) {
+        const uint8_t code = to_code[sequence.ptr[i]];
+        if (code != PACKED_NO_CODE) {
+            const std::size_t bit = i * bits.val;
+            data[bit / 8] |= code << (bit % 8);
+        } else {
+            const uint32_t pos = i;
+            memcpy(exception, &pos, sizeof(uint32_t));
+            exception[sizeof(uint32_t)] = toupper(sequence.ptr[i]);
+            exception += PACKED_EXCEPTION;
+        }
+    }
+
+    return result;
+}
+
+IMPALA_UDF_EXPORT
+StringVal NT_Pack(FunctionContext *context, const StringVal &sequence) {
+    return NT_Pack_Bits(context, sequence, IntVal(4));
+}
+
+IMPALA_UDF_EXPORT
+StringVal NT_Unpack(FunctionContext *context, const StringVal &packed) {
+    PackedSeq p;
+    if (!packed_view(packed, p) || p.n == 0) {
+        return StringVal::null();
+    }
+
+    StringVal result(context, p.n);
+    if (result.is_null) {
+        return result;
+    }
+
+    const char *from_code = p.bits == 4 ? FROM_NT4 : FROM_NT2;
+    for (std::size_t i = 0; i < p.n; i++) {
+        result.ptr[i] = from_code[packed_code(p, i)];
+    }
+    // packed_view has checked that every exception position is within the sequence
+    for (uint32_t k = 0; k < p.n_exceptions; k++) {
+        result.ptr[packed_exception_pos(p, k)] = packed_exception_sym(p, k);
+    }
+
+    return result;
+}
+
+// Both arguments must be packed with the same number of bits
+inline bool packed_pair(
+    const StringVal &packed1, const StringVal &packed2, PackedSeq &p1, PackedSeq &p2
+) {
+    return packed_view(packed1, p1) && packed_view(packed2, p2) && p1.bits == p2.bits &&
+           p1.n > 0 && p2.n > 0;
+}
+
+// Word-level mismatch count (XOR + popcount) followed by a correction at exception sites using the
+// unpacked comparison, so results match the unpacked function exactly.
+template <typename LANES, typename CODE, typename SYMBOL>
+inline int packed_mismatches(
+    const PackedSeq &p1, const PackedSeq &p2, LANES &&lanes, CODE &&code_diff, SYMBOL &&symbol_diff
+) {
+    const std::size_t n     = std::min(p1.n, p2.n);
+    const std::size_t words = (n * p1.bits + 63) / 64;
+
+    int d = 0;
+    for (std::size_t w = 0; w < words; w++) {
+        d += std::popcount(lanes(packed_word(p1, w, n), packed_word(p2, w, n)));
+    }
+
+    packed_exceptions_union(p1, p2, n, [&](std::size_t pos) {
+        d += symbol_diff(packed_symbol(p1, pos), packed_symbol(p2, pos)) -
+             code_diff(packed_code(p1, pos), packed_code(p2, pos));
+    });
+
+    return d;
+}
+
+IMPALA_UDF_EXPORT
+IntVal Nt_Distance_Packed(
+    FunctionContext *context, const StringVal &packed1, const StringVal &packed2
+) {
+    PackedSeq p1, p2;
+    if (!packed_pair(packed1, packed2, p1, p2)) {
+        return IntVal::null();
+    }
+
+    auto symbol_diff = [](uint8_t a, uint8_t b) { return NTD[a][b]; };
+    if (p1.bits == 4) {
+        return IntVal(packed_mismatches(p1, p2, ntd_lanes4, ntd_code4, symbol_diff));
+    } else {
+        return IntVal(packed_mismatches(
+            p1, p2, [](uint64_t a, uint64_t b) { return nonzero_lanes2(a ^ b); },
+            [](uint8_t a, uint8_t b) { return static_cast<int>(a != b); }, symbol_diff
+        ));
+    }
+}
+
+IMPALA_UDF_EXPORT
+IntVal Hamming_Distance_Packed(
+    FunctionContext *context, const StringVal &packed1, const StringVal &packed2
+) {
+    PackedSeq p1, p2;
+    if (!packed_pair(packed1, packed2, p1, p2)) {
+        return IntVal::null();
+    }
+
+    // Symbols are stored upper-case, so only missing data needs special handling
+    auto symbol_diff = [](uint8_t a, uint8_t b) {
+        return static_cast<int>(a != b && a != '.' && b != '.');
+    };
+    auto code_diff = [](uint8_t a, uint8_t b) { return static_cast<int>(a != b); };
+    if (p1.bits == 4) {
+        return IntVal(packed_mismatches(
+            p1, p2, [](uint64_t a, uint64_t b) { return nonzero_lanes4(a ^ b); }, code_diff,
+            symbol_diff
+        ));
+    } else {
+        return IntVal(packed_mismatches(
+            p1, p2, [](uint64_t a, uint64_t b) { return nonzero_lanes2(a ^ b); }, code_diff,
+            symbol_diff
+        ));
+    }
+}
+
+// Substitution counts between A, C, G, T using one popcount per cell and word
+inline std::array<std::array<unsigned int, 4>, 4> packed_sub_matrix(
+    const PackedSeq &p1, const PackedSeq &p2
+) {
+    std::array<std::array<unsigned int, 4>, 4> sub = {0};
+
+    const std::size_t n     = std::min(p1.n, p2.n);
+    const std::size_t lanes = 64 / p1.bits;
+    const std::size_t words = (n + lanes - 1) / lanes;
+    const uint64_t LANE     = p1.bits == 4 ? LANE4 : LANE2;
+
+    for (std::size_t w = 0; w < words; w++) {
+        const uint64_t a = packed_word(p1, w, n);
+        const uint64_t b = packed_word(p2, w, n);
+
+        uint64_t valid = LANE;
+        if (n - w * lanes < lanes) {
+            valid &= (uint64_t(1) << ((n - w * lanes) * p1.bits)) - 1;
+        }
+
+        std::array<uint64_t, 4> eq1, eq2;
+        for (int k = 0; k < 4; k++) {
+            if (p1.bits == 4) {
+                eq1[k] = equal_lanes4(a, 1 << k) & valid;
+                eq2[k] = equal_lanes4(b, 1 << k) & valid;
+            } else {
+                eq1[k] = equal_lanes2(a, k) & valid;
+                eq2[k] = equal_lanes2(b, k) & valid;
+            }
+        }
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                sub[i][j] += std::popcount(eq1[i] & eq2[j]);
+            }
+        }
+    }
+
+    auto code_index = [&](uint8_t code) -> std::size_t {
+        return p1.bits == 4 ? NT4_TO_PROFILE_INDEX[code] : code;
+    };
+    packed_exceptions_union(p1, p2, n, [&](std::size_t pos) {
+        std::size_t i = code_index(packed_code(p1, pos));
+        std::size_t j = code_index(packed_code(p2, pos));
+        if (i < 4 && j < 4) {
+            sub[i][j]--;
+        }
+
+        i = toDNAProfileIndex(packed_symbol(p1, pos));
+        j = toDNAProfileIndex(packed_symbol(p2, pos));
+        if (i < 4 && j < 4) {
+            sub[i][j]++;
+        }
+    });
+
+    return sub;
+}
+
+IMPALA_UDF_EXPORT
+DoubleVal Tn_93_Distance_Packed(
+    FunctionContext *context, const StringVal &packed1, const StringVal &packed2
+) {
+    PackedSeq p1, p2;
+    if (!packed_pair(packed1, packed2, p1, p2)) {
+        return DoubleVal::null();
+    }
+
+    auto [k1, k2, k3, _, w1, w2, w3] = Tn_93_Matrix_Variables(packed_sub_matrix(p1, p2));
+
+    double dist = -k1 * log(w1) - k2 * log(w2) - k3 * log(w3);
+
+    if (std::isnan(dist) || std::isinf(dist)) {
+        return DoubleVal::null();
+    }
+
+    return DoubleVal(dist);
+}
+
+/* Alignment functions */
+
+// Nucleotide scores in the style of NUC.4.4: ambiguous codes compatible with the other base are
+// neither rewarded nor penalized. Gap costs and traceback flags are in udx-align.h.
+const int ALIGN_MATCH          = 5;
+const int ALIGN_MISMATCH       = -4;
+const int ALIGN_DEFAULT_BAND   = 64;
+const std::size_t ALIGN_BUDGET = 64 * 1024 * 1024;
+
+inline int align_score(uint8_t a, uint8_t b) {
+    const uint8_t mask_a = NT_IUPAC_MASK[a];
+    const uint8_t mask_b = NT_IUPAC_MASK[b];
+    if (mask_a == mask_b && std::popcount(mask_a) == 1) {
+        return ALIGN_MATCH;
+    } else if (mask_a & mask_b) {
+        return 0;
+    } else if (mask_a == 0 && mask_b == 0 && ascii_upper(a) == ascii_upper(b)) {
+        return ALIGN_MATCH;
+    }
+    return ALIGN_MISMATCH;
+}
+
+// Query bytes in the same class score alike against every reference byte
+const std::size_t ALIGN_SCORE_CLASSES = 16 + 256;
+
+inline std::size_t align_score_class(uint8_t c) {
+    return NT_IUPAC_MASK[c] != 0 ? NT_IUPAC_MASK[c] : 16 + ascii_upper(c);
+}
+
+struct BandedAlignment {
+    std::string aligned;                                         // query in reference coordinates
+    std::vector<std::pair<std::size_t, std::string>> insertions; // after a reference position
+};
+
+// Global alignment with affine gaps (Gotoh) restricted to diagonals within `band` of the main
+// diagonal, widened by the length difference so both corners are always reachable. Rows are the
+// query and columns the reference. Each row of the band is filled by align_band_row from the
+// scores of its query byte against the whole reference, computed once per class of query byte;
+// only the band of traceback bytes is stored.
+static bool banded_align(
+    const uint8_t *q, std::size_t m, const uint8_t *r, std::size_t n, int band, BandedAlignment &out
+) {
+    const long lo       = std::min(0L, static_cast<long>(n) - static_cast<long>(m)) - band;
+    const long hi       = std::max(0L, static_cast<long>(n) - static_cast<long>(m)) + band;
+    const std::size_t W = hi - lo + 1;
+    if ((m + 1) > ALIGN_BUDGET / W) {
+        return false;
+    }
+
+    // Rows are in diagonal coordinates, cell b of row i is column i + lo + b. The extra cell past
+    // the band is read as the cell above the last one.
+    std::vector<uint8_t> trace((m + 1) * W, 0);
+    std::vector<int32_t> H_prev(W + 1, ALIGN_NEG_INF), H_cur(W + 1, ALIGN_NEG_INF);
+    std::vector<int32_t> F_prev(W + 1, ALIGN_NEG_INF), F_cur(W + 1, ALIGN_NEG_INF);
+    auto tb = [&](std::size_t i, std::size_t j) -> uint8_t & {
+        return trace[i * W + (static_cast<long>(j) - static_cast<long>(i) - lo)];
+    };
+
+    std::vector<std::vector<int8_t>> profiles;
+    std::vector<int> profile_of(ALIGN_SCORE_CLASSES, -1);
+    auto profile = [&](uint8_t c) -> const int8_t * {
+        int &index = profile_of[align_score_class(c)];
+        if (index < 0) {
+            index = profiles.size();
+            profiles.emplace_back(n);
+            for (std::size_t j = 0; j < n; j++) {
+                profiles.back()[j] = align_score(c, r[j]);
+            }
+        }
+        return profiles[index].data();
+    };
+
+    const std::size_t first_hi = std::min(static_cast<long>(n), hi);
+    H_prev[-lo]                = 0;
+    for (std::size_t j = 1; j <= first_hi; j++) {
+        H_prev[j - lo] = -(ALIGN_GAP_OPEN + static_cast<int>(j) * ALIGN_GAP_EXTEND);
+        tb(0, j)       = ALIGN_FROM_DEL | (j > 1 ? ALIGN_DEL_EXTEND : 0);
+    }
+
+    for (std::size_t i = 1; i <= m; i++) {
+        const long row_lo      = static_cast<long>(i) + lo;
+        const std::size_t j_lo = std::max(0L, row_lo);
+        const std::size_t j_hi = std::min(static_cast<long>(n), static_cast<long>(i) + hi);
+        const std::size_t b_lo = j_lo - row_lo;
+        const std::size_t b_hi = j_hi - row_lo;
+        int32_t h_left         = ALIGN_NEG_INF;
+        int32_t e_left         = ALIGN_NEG_INF;
+
+        // Cells before the first or past the last column are unreachable
+        std::fill(H_cur.begin(), H_cur.begin() + b_lo, ALIGN_NEG_INF);
+        std::fill(F_cur.begin(), F_cur.begin() + b_lo, ALIGN_NEG_INF);
+        std::fill(H_cur.begin() + b_hi + 1, H_cur.begin() + W, ALIGN_NEG_INF);
+        std::fill(F_cur.begin() + b_hi + 1, F_cur.begin() + W, ALIGN_NEG_INF);
+
+        std::size_t j = j_lo;
+        if (j_lo == 0) {
+            h_left      = -(ALIGN_GAP_OPEN + static_cast<int>(i) * ALIGN_GAP_EXTEND);
+            H_cur[b_lo] = h_left;
+            F_cur[b_lo] = h_left;
+            tb(i, 0)    = ALIGN_FROM_INS | (i > 1 ? ALIGN_INS_EXTEND : 0);
+            j           = 1;
+        }
+
+        const std::size_t b = j - row_lo;
+        align_band_row(
+            H_prev.data() + b, F_prev.data() + b, profile(q[i - 1]) + (j - 1), H_cur.data() + b,
+            F_cur.data() + b, &trace[i * W + b], j_hi - j + 1, h_left, e_left
+        );
+        std::swap(H_prev, H_cur);
+        std::swap(F_prev, F_cur);
+    }
+
+    out.aligned.assign(n, '-');
+    out.insertions.clear();
+
+    enum { STATE_H, STATE_DEL, STATE_INS } state = STATE_H;
+
+    std::size_t i = m;
+    std::size_t j = n;
+    while (i > 0 || j > 0) {
+        const uint8_t t = tb(i, j);
+        if (state == STATE_H) {
+            switch (t & 3) {
+            case ALIGN_FROM_DEL:
+                state = STATE_DEL;
+                break;
+            case ALIGN_FROM_INS:
+                state = STATE_INS;
+                break;
+            default:
+                out.aligned[j - 1] = q[i - 1];
+                i--;
+                j--;
+            }
+        } else if (state == STATE_DEL) {
+            state = (t & ALIGN_DEL_EXTEND) ? STATE_DEL : STATE_H;
+            j--;
+        } else {
+            if (out.insertions.empty() || out.insertions.back().first != j) {
+                out.insertions.emplace_back(j, "");
+            }
+            out.insertions.back().second += q[i - 1];
+            state = (t & ALIGN_INS_EXTEND) ? STATE_INS : STATE_H;
+            i--;
+        }
+    }
+
+    // Traceback runs backwards
+    std::reverse(out.insertions.begin(), out.insertions.end());
+    for (auto &insertion : out.insertions) {
+        std::reverse(insertion.second.begin(), insertion.second.end());
+    }
+    return true;
+}
+
+static bool align_args(
+    const StringVal &query, const StringVal &reference, const IntVal &bandVal,
+    BandedAlignment &out
+) {
+    if (query.is_null || reference.is_null || bandVal.is_null) {
+        return false;
+    }
+    if (query.len == 0 || reference.len == 0 || bandVal.val < 0) {
+        return false;
+    }
+    return banded_align(query.ptr, query.len, reference.ptr, reference.len, bandVal.val, out);
+}
+
+IMPALA_UDF_EXPORT
+StringVal Align_To_Reference_Band(
+    FunctionContext *context, const StringVal &query, const StringVal &reference,
+    const IntVal &bandVal
+) {
+    BandedAlignment alignment;
+    if (!align_args(query, reference, bandVal, alignment)) {
+        return StringVal::null();
+    }
+    return to_StringVal(context, alignment.aligned);
+}
+
+IMPALA_UDF_EXPORT
+StringVal Align_To_Reference(
+    FunctionContext *context, const StringVal &query, const StringVal &reference
+) {
+    return Align_To_Reference_Band(context, query, reference, IntVal(ALIGN_DEFAULT_BAND));
+}
+
+IMPALA_UDF_EXPORT
+StringVal Alignment_Insertions_Band(
+    FunctionContext *context, const StringVal &query, const StringVal &reference,
+    const IntVal &bandVal
+) {
+    BandedAlignment alignment;
+    if (!align_args(query, reference, bandVal, alignment)) {
+        return StringVal::null();
+    }
+
+    std::string buffer = "";
+    for (const auto &[position, bases] : alignment.insertions) {
+        if (!buffer.empty()) {
+            buffer += ", ";
+        }
+        append_int(buffer, position);
+        buffer += ':';
+        buffer += bases;
+    }
+    return to_StringVal(context, buffer);
+}
+
+IMPALA_UDF_EXPORT
+StringVal Alignment_Insertions(
+    FunctionContext *context, const StringVal &query, const StringVal &reference
+) {
+    return Alignment_Insertions_Band(context, query, reference, IntVal(ALIGN_DEFAULT_BAND));
+}
@@ -3,33 +3,24 @@
 #ifndef UDF_BIOUTILS_H
 #define UDF_BIOUTILS_H
 
-#include "boost/date_time/gregorian/gregorian.hpp"
 #include <impala_udf/udf.h>
 #include <string>
+#include <string_view>
 #include <vector>
 
 using namespace impala_udf;
 
-// Epi week structure
-struct epiweek_t {
-    int year;
-    int week;
-};
+// Julian day number of 1970-01-01; TimestampVal::date counts days from the Julian origin while
+// DateVal counts from the Unix epoch
+constexpr int EPOCH_OFFSET = 2440588;
 
-int get_epoch_offset() {
-    boost::gregorian::date EPOCH(1970, 1, 1);
-    return EPOCH.day_number();
-}
-static int EPOCH_OFFSET = get_epoch_offset();
+// opt-in result cache hooks
+void Memo_Prepare(FunctionContext *context, FunctionContext::FunctionStateScope scope);
+void Memo_Close(FunctionContext *context, FunctionContext::FunctionStateScope scope);
 
-int get_final_saturday() {
-    boost::gregorian::date EPOCH(9999, 12, 31);
-    return EPOCH.day_number() + 1;
-}
-static int FINAL_SATURDAY = get_final_saturday();
-
-// private functions
-struct epiweek_t date_to_epiweek(boost::gregorian::date d);
+// date string parse cache hooks
+void Date_Parse_Prepare(FunctionContext *context, FunctionContext::FunctionStateScope scope);
+void Date_Parse_Close(FunctionContext *context, FunctionContext::FunctionStateScope scope);
 
 StringVal Sort_List_By_Substring(
     FunctionContext *context, const StringVal &listVal, const StringVal &delimVal
@@ -87,6 +78,11 @@ IntVal Hamming_Distance_Pairwise_Delete(
 IntVal Nt_Distance(
     FunctionContext *context, const StringVal &sequence1, const StringVal &sequence2
 );
+void Nearest_Reference_Prepare(FunctionContext *context, FunctionContext::FunctionStateScope scope);
+void Nearest_Reference_Close(FunctionContext *context, FunctionContext::FunctionStateScope scope);
+StringVal Nearest_Reference(
+    FunctionContext *context, const StringVal &sequence, const StringVal &panelVal
+);
 StringVal Sequence_Diff(FunctionContext *context, const StringVal &seq1, const StringVal &seq2);
 StringVal Sequence_Diff_NT(FunctionContext *context, const StringVal &seq1, const StringVal &seq2);
 DoubleVal Physiochemical_Distance(
@@ -95,10 +91,14 @@ DoubleVal Physiochemical_Distance(
 StringVal Physiochemical_Distance_List(
     FunctionContext *context, const StringVal &sequence1, const StringVal &sequence2
 );
+void Contains_Element_Prepare(FunctionContext *context, FunctionContext::FunctionStateScope scope);
+void Contains_Element_Close(FunctionContext *context, FunctionContext::FunctionStateScope scope);
 BooleanVal Contains_An_Element(
     FunctionContext *context, const StringVal &string1, const StringVal &string2,
     const StringVal &delimVal
 );
+void Is_Element_Prepare(FunctionContext *context, FunctionContext::FunctionStateScope scope);
+void Is_Element_Close(FunctionContext *context, FunctionContext::FunctionStateScope scope);
 BooleanVal Is_An_Element(
     FunctionContext *context, const StringVal &string1, const StringVal &string2,
     const StringVal &delimVal
@@ -106,15 +106,38 @@ BooleanVal Is_An_Element(
 BooleanVal Contains_Symmetric(
     FunctionContext *context, const StringVal &string1, const StringVal &string2
 );
+BooleanVal Contains_Symmetric_Ignore_Case(
+    FunctionContext *context, const StringVal &string1, const StringVal &string2
+);
 StringVal Complete_String_Date(FunctionContext *context, const StringVal &dateStr);
 StringVal nt_id(FunctionContext *context, const StringVal &sequence);
 StringVal variant_hash(FunctionContext *context, const StringVal &sequence);
+std::vector<std::string> nt_id_batch(const std::vector<std::string_view> &sequences);
+std::vector<std::string> variant_hash_batch(const std::vector<std::string_view> &sequences);
+StringVal nt_fingerprint(FunctionContext *context, const StringVal &sequence);
+BigIntVal nt_fingerprint_hi(FunctionContext *context, const StringVal &sequence);
+BigIntVal nt_fingerprint_lo(FunctionContext *context, const StringVal &sequence);
+StringVal aa_fingerprint(FunctionContext *context, const StringVal &sequence);
+BigIntVal aa_fingerprint_hi(FunctionContext *context, const StringVal &sequence);
+BigIntVal aa_fingerprint_lo(FunctionContext *context, const StringVal &sequence);
+StringVal Nt_Sketch(FunctionContext *context, const StringVal &sequence);
+StringVal Nt_Sketch_K_S(
+    FunctionContext *context, const StringVal &sequence, const IntVal &kVal, const IntVal &sVal
+);
+DoubleVal Sketch_Similarity(
+    FunctionContext *context, const StringVal &sketch1, const StringVal &sketch2
+);
+DoubleVal Sketch_Distance(
+    FunctionContext *context, const StringVal &sketch1, const StringVal &sketch2
+);
 StringVal Range_From_List(
     FunctionContext *context, const StringVal &listVal, const StringVal &delimVal
 );
 StringVal md5(FunctionContext *context, int num_vars, const StringVal *args);
 StringVal nt_std(FunctionContext *context, const StringVal &sequence);
 StringVal aa_std(FunctionContext *context, const StringVal &sequence);
+void Find_Set_Prepare(FunctionContext *context, FunctionContext::FunctionStateScope scope);
+void Find_Set_Close(FunctionContext *context, FunctionContext::FunctionStateScope scope);
 BooleanVal Find_Set_In_String(
     FunctionContext *context, const StringVal &haystackVal, const StringVal &needlesVal
 );
@@ -137,6 +160,8 @@ DateVal Double_to_Date(FunctionContext *context, const DoubleVal &doubleVal);
 IntVal Longest_Deletion(FunctionContext *context, const StringVal &sequence);
 IntVal Number_Deletions(FunctionContext *context, const StringVal &sequence);
 
+void Cut_Paste_Prepare(FunctionContext *context, FunctionContext::FunctionStateScope scope);
+void Cut_Paste_Close(FunctionContext *context, FunctionContext::FunctionStateScope scope);
 StringVal Cut_Paste(
     FunctionContext *context, const StringVal &my_string, const StringVal &delim,
     const StringVal &range_map
@@ -194,9 +219,51 @@ DateVal Fortnight_Date_STR(FunctionContext *context, const StringVal &dateStr);
 DateVal Fortnight_Date_TS(FunctionContext *context, const TimestampVal &tsVal);
 DateVal Fortnight_Date(FunctionContext *context, const DateVal &dateVal);
 
+void Period_Ending_Prepare(FunctionContext *context, FunctionContext::FunctionStateScope scope);
+void Period_Ending_Close(FunctionContext *context, FunctionContext::FunctionStateScope scope);
+DateVal Period_Ending_Date(
+    FunctionContext *context, const DateVal &dateVal, const IntVal &periodVal,
+    const DateVal &anchorVal
+);
+DateVal Period_Ending_Date_TS(
+    FunctionContext *context, const TimestampVal &tsVal, const IntVal &periodVal,
+    const DateVal &anchorVal
+);
+DateVal Period_Ending_Date_STR(
+    FunctionContext *context, const StringVal &dateStr, const IntVal &periodVal,
+    const DateVal &anchorVal
+);
+
 DoubleVal Tn_93_Distance(FunctionContext *context, const StringVal &seq1, const StringVal &seq2);
 DoubleVal Tn_93_Gamma(
     FunctionContext *context, const StringVal &seq1, const StringVal &seq2, const DoubleVal &alpha
 );
 DoubleVal Calculate_Entropy(FunctionContext *context, const StringVal &s);
+
+StringVal NT_Pack(FunctionContext *context, const StringVal &sequence);
+StringVal NT_Pack_Bits(FunctionContext *context, const StringVal &sequence, const IntVal &bits);
+StringVal NT_Unpack(FunctionContext *context, const StringVal &packed);
+IntVal Nt_Distance_Packed(
+    FunctionContext *context, const StringVal &packed1, const StringVal &packed2
+);
+IntVal Hamming_Distance_Packed(
+    FunctionContext *context, const StringVal &packed1, const StringVal &packed2
+);
+DoubleVal Tn_93_Distance_Packed(
+    FunctionContext *context, const StringVal &packed1, const StringVal &packed2
+);
+StringVal Align_To_Reference(
+    FunctionContext *context, const StringVal &query, const StringVal &reference
+);
+StringVal Align_To_Reference_Band(
+    FunctionContext *context, const StringVal &query, const StringVal &reference,
+    const IntVal &bandVal
+);
+StringVal Alignment_Insertions(
+    FunctionContext *context, const StringVal &query, const StringVal &reference
+);
+StringVal Alignment_Insertions_Band(
+    FunctionContext *context, const StringVal &query, const StringVal &reference,
+    const IntVal &bandVal
+);
 #endif
@@ -0,0 +1,99 @@
+// Aho-Corasick automaton used by contains_element to find any of a constant list of substrings in
+// a single pass over the haystack.
+//
+// Goto and failure links are folded into one dense transition table. Columns are byte classes:
+// each byte occurring in some pattern has its own class and all other bytes share class 0, so a
+// list of lineage names needs a few dozen columns rather than 256. Entries hold the next state's
+// row offset, or -1 when the next state ends a pattern, so the scan is one load per byte.
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+class AhoCorasick {
+  public:
+    // Patterns is any range of string_view that can be iterated twice; empty patterns are ignored
+    template <typename Patterns>
+    explicit AhoCorasick(const Patterns &patterns) {
+        memset(byte_class, 0, sizeof(byte_class));
+        classes = 1;
+        for (std::string_view pattern : patterns) {
+            for (unsigned char c : pattern) {
+                if (byte_class[c] == 0) {
+                    byte_class[c] = classes++;
+                }
+            }
+        }
+
+        // Trie of the patterns, -1 where there is no edge
+        std::vector<int32_t> go(classes, -1);
+        std::vector<uint8_t> accept(1, 0);
+        int32_t states = 1;
+        for (std::string_view pattern : patterns) {
+            if (pattern.empty()) {
+                continue;
+            }
+            int32_t s = 0;
+            for (unsigned char c : pattern) {
+                const std::size_t edge = std::size_t(s) * classes + byte_class[c];
+                if (go[edge] < 0) {
+                    go[edge] = states++;
+                    go.resize(std::size_t(states) * classes, -1);
+                    accept.push_back(0);
+                }
+                s = go[edge];
+            }
+            accept[s] = 1;
+        }
+
+        // Breadth-first, missing edges are copied from the failure state whose row is complete
+        std::vector<int32_t> fail(states, 0);
+        std::vector<int32_t> queue;
+        queue.reserve(states);
+        for (uint32_t k = 0; k < classes; k++) {
+            if (go[k] < 0) {
+                go[k] = 0;
+            } else {
+                queue.push_back(go[k]);
+            }
+        }
+        for (std::size_t i = 0; i < queue.size(); i++) {
+            const int32_t s = queue[i];
+            accept[s] |= accept[fail[s]];
+            for (uint32_t k = 0; k < classes; k++) {
+                int32_t &t        = go[std::size_t(s) * classes + k];
+                const int32_t via  = go[std::size_t(fail[s]) * classes + k];
+                if (t < 0) {
+                    t = via;
+                } else {
+                    fail[t] = via;
+                    queue.push_back(t);
+                }
+            }
+        }
+
+        next.resize(go.size());
+        for (std::size_t i = 0; i < go.size(); i++) {
+            next[i] = accept[go[i]] ? -1 : go[i] * static_cast<int32_t>(classes);
+        }
+    }
+
+    // True if any pattern occurs in the text
+    bool search(std::string_view text) const {
+        const int32_t *table = next.data();
+        int32_t row          = 0;
+        for (unsigned char c : text) {
+            row = table[row + byte_class[c]];
+            if (row < 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+  private:
+    uint32_t byte_class[256];
+    uint32_t classes;
+    std::vector<int32_t> next;
+};
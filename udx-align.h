@@ -0,0 +1,147 @@
+// One row of the banded Gotoh alignment used by align_to_reference and alignment_insertions.
+//
+// The band is stored in diagonal coordinates: cell b of row i is column j = i + lo + b, so the
+// cell above is b + 1 and the diagonal cell is b of the previous row, and the cell to the left is
+// b - 1 of this row. H (best score) and F (gap in the reference) only read the previous row and
+// are computed 8 cells at a time. The remaining serial dependency is E (gap in the query) along
+// the row. With G = max(diagonal, F) it is
+//     E[b] + b * extend = max(E[b - 1] + (b - 1) * extend, G[b - 1] - open - extend + b * extend)
+// a running maximum that AVX2 computes with three lane shifts per vector, carrying the last E and
+// H into the next vector. Lanes are 32-bit so scores of genome-length sequences cannot overflow.
+// Non-AVX2 builds and the last cells of a row use the same recurrence one cell at a time.
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// The first gap character costs open + extend
+const int ALIGN_GAP_OPEN   = 10;
+const int ALIGN_GAP_EXTEND = 1;
+const int ALIGN_NEG_INF    = -(1 << 30);
+
+// Traceback: the low two bits give the source of H, the flags whether E or F was extended
+const uint8_t ALIGN_FROM_DIAG  = 0;
+const uint8_t ALIGN_FROM_DEL   = 1;
+const uint8_t ALIGN_FROM_INS   = 2;
+const uint8_t ALIGN_DEL_EXTEND = 4;
+const uint8_t ALIGN_INS_EXTEND = 8;
+
+#ifdef __AVX2__
+// Lane l of the result is lane l - k of v, the first k lanes are taken from fill
+template <int K>
+inline __m256i align_shift_lanes(__m256i v, __m256i fill) {
+    const __m256i index = _mm256_setr_epi32(-K, 1 - K, 2 - K, 3 - K, 4 - K, 5 - K, 6 - K, 7 - K);
+    return _mm256_blend_epi32(_mm256_permutevar8x32_epi32(v, index), fill, (1 << K) - 1);
+}
+#endif
+
+// Fills `count` cells of a row. Each input and output pointer is at the first cell; h_prev and
+// f_prev hold count + 1 cells. score holds the substitution score of each cell's diagonal step.
+// h_left and e_left are H and E of the cell left of the first one and are left at the last cell.
+inline void align_band_row(
+    const int32_t *h_prev, const int32_t *f_prev, const int8_t *score, int32_t *h_cur,
+    int32_t *f_cur, uint8_t *trace, std::size_t count, int32_t &h_left, int32_t &e_left
+) {
+    const int32_t open_extend = ALIGN_GAP_OPEN + ALIGN_GAP_EXTEND;
+    std::size_t b             = 0;
+
+#ifdef __AVX2__
+    const __m256i v_open   = _mm256_set1_epi32(open_extend);
+    const __m256i v_extend = _mm256_set1_epi32(ALIGN_GAP_EXTEND);
+    const __m256i v_min    = _mm256_set1_epi32(INT32_MIN);
+    const __m256i v_lanes  = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i v_ramp   = _mm256_mullo_epi32(v_lanes, v_extend);
+    const __m256i v_del    = _mm256_set1_epi32(ALIGN_FROM_DEL);
+    const __m256i v_ins    = _mm256_set1_epi32(ALIGN_FROM_INS);
+    const __m256i v_del_x  = _mm256_set1_epi32(ALIGN_DEL_EXTEND);
+    const __m256i v_ins_x  = _mm256_set1_epi32(ALIGN_INS_EXTEND);
+    // Low byte of each lane, gathered into the first 8 bytes
+    const __m256i v_bytes = _mm256_setr_epi8(
+        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 4, 8, 12, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1
+    );
+    auto load = [](const int32_t *p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    };
+
+    for (; b + 8 <= count; b += 8) {
+        const __m256i up   = load(h_prev + b + 1);
+        const __m128i s8   = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(score + b));
+        const __m256i diag = _mm256_add_epi32(load(h_prev + b), _mm256_cvtepi8_epi32(s8));
+        const __m256i f_op = _mm256_sub_epi32(up, v_open);
+        const __m256i f_ex = _mm256_sub_epi32(load(f_prev + b + 1), v_extend);
+        const __m256i f    = _mm256_max_epi32(f_op, f_ex);
+        const __m256i g    = _mm256_max_epi32(diag, f);
+
+        // G of the cell to the left, with H of the previous cell standing in for the first lane
+        const __m256i g_left = align_shift_lanes<1>(g, _mm256_set1_epi32(h_left));
+        __m256i y            = _mm256_add_epi32(_mm256_sub_epi32(g_left, v_open), v_ramp);
+        y = _mm256_max_epi32(y, align_shift_lanes<1>(y, v_min));
+        y = _mm256_max_epi32(y, align_shift_lanes<2>(y, v_min));
+        y = _mm256_max_epi32(y, align_shift_lanes<4>(y, v_min));
+        y = _mm256_max_epi32(y, _mm256_set1_epi32(e_left - ALIGN_GAP_EXTEND));
+        const __m256i e      = _mm256_sub_epi32(y, v_ramp);
+        const __m256i e_prev = align_shift_lanes<1>(e, _mm256_set1_epi32(e_left));
+
+        const __m256i from_del = _mm256_cmpgt_epi32(e, diag);
+        const __m256i h_de     = _mm256_max_epi32(diag, e);
+        const __m256i from_ins = _mm256_cmpgt_epi32(f, h_de);
+        const __m256i h        = _mm256_max_epi32(h_de, f);
+        const __m256i del_ext  = _mm256_cmpgt_epi32(
+            _mm256_sub_epi32(e_prev, v_extend), _mm256_sub_epi32(g_left, v_open)
+        );
+        const __m256i ins_ext = _mm256_cmpgt_epi32(f_ex, f_op);
+
+        __m256i t = _mm256_blendv_epi8(_mm256_and_si256(from_del, v_del), v_ins, from_ins);
+        t = _mm256_or_si256(t, _mm256_and_si256(del_ext, v_del_x));
+        t = _mm256_or_si256(t, _mm256_and_si256(ins_ext, v_ins_x));
+        t = _mm256_permutevar8x32_epi32(
+            _mm256_shuffle_epi8(t, v_bytes), _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0)
+        );
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(h_cur + b), h);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(f_cur + b), f);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(trace + b), _mm256_castsi256_si128(t));
+        h_left = _mm256_extract_epi32(h, 7);
+        e_left = _mm256_extract_epi32(e, 7);
+    }
+#endif
+
+    for (; b < count; b++) {
+        uint8_t t = 0;
+
+        const int32_t e_open = h_left - open_extend;
+        const int32_t e_ext  = e_left - ALIGN_GAP_EXTEND;
+        if (e_ext > e_open) {
+            e_left = e_ext;
+            t |= ALIGN_DEL_EXTEND;
+        } else {
+            e_left = e_open;
+        }
+
+        const int32_t f_open = h_prev[b + 1] - open_extend;
+        const int32_t f_ext  = f_prev[b + 1] - ALIGN_GAP_EXTEND;
+        if (f_ext > f_open) {
+            f_cur[b] = f_ext;
+            t |= ALIGN_INS_EXTEND;
+        } else {
+            f_cur[b] = f_open;
+        }
+
+        int32_t h = h_prev[b] + score[b];
+        if (e_left > h) {
+            h = e_left;
+            t |= ALIGN_FROM_DEL;
+        }
+        if (f_cur[b] > h) {
+            h = f_cur[b];
+            t = (t & ~ALIGN_FROM_DEL) | ALIGN_FROM_INS;
+        }
+        h_cur[b] = h;
+        trace[b] = t;
+        h_left   = h;
+    }
+}
@@ -0,0 +1,77 @@
+// Set of bytes searched for 32 haystack bytes at a time, used by any_instr and by contains_element
+// with an empty delimiter.
+//
+// The set is a 16x16 bitmap indexed by the low and high nibbles of a byte. Each low nibble has
+// one row byte for the high nibbles 0-7 and one for 8-15. With AVX2, vpshufb looks up both rows
+// and the bit for the high nibble for every byte of a vector, and the row is picked by the byte's
+// top bit. Two vectors are tested per step; the tail and non-AVX2 builds use a 256-entry table.
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+class ByteSet {
+  public:
+    explicit ByteSet(std::string_view bytes) {
+        memset(member, 0, sizeof(member));
+        memset(rows_low, 0, sizeof(rows_low));
+        memset(rows_high, 0, sizeof(rows_high));
+        for (unsigned char c : bytes) {
+            member[c] = true;
+            (c < 0x80 ? rows_low : rows_high)[c & 0x0F] |= 1 << ((c >> 4) & 7);
+        }
+    }
+
+    // True if any byte of the text is in the set
+    bool search(std::string_view text) const {
+        const uint8_t *p   = reinterpret_cast<const uint8_t *>(text.data());
+        const uint8_t *end = p + text.size();
+#ifdef __AVX2__
+        const __m128i low_rows  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows_low));
+        const __m128i high_rows = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows_high));
+        const __m256i low       = _mm256_broadcastsi128_si256(low_rows);
+        const __m256i high      = _mm256_broadcastsi128_si256(high_rows);
+        const __m256i bits      = _mm256_set1_epi64x(0x8040201008040201);
+        const __m256i nibble    = _mm256_set1_epi8(0x0F);
+
+        // Nonzero bytes mark members of the set
+        auto find = [&](const uint8_t *q) {
+            const __m256i v   = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(q));
+            const __m256i lo  = _mm256_and_si256(v, nibble);
+            const __m256i hi  = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+            const __m256i row = _mm256_blendv_epi8(
+                _mm256_shuffle_epi8(low, lo), _mm256_shuffle_epi8(high, lo), v
+            );
+            return _mm256_and_si256(row, _mm256_shuffle_epi8(bits, hi));
+        };
+        for (; end - p >= 64; p += 64) {
+            const __m256i hits = _mm256_or_si256(find(p), find(p + 32));
+            if (!_mm256_testz_si256(hits, hits)) {
+                return true;
+            }
+        }
+        if (end - p >= 32) {
+            const __m256i hits = find(p);
+            if (!_mm256_testz_si256(hits, hits)) {
+                return true;
+            }
+            p += 32;
+        }
+#endif
+        for (; p < end; p++) {
+            if (member[*p]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+  private:
+    uint8_t rows_low[16];
+    uint8_t rows_high[16];
+    bool member[256];
+};
@@ -0,0 +1,162 @@
+// Integer calendar arithmetic on day numbers counted from the Unix epoch (Impala's DATE), after
+// Howard Hinnant's algorithms (https://howardhinnant.github.io/date_algorithms.html), valid over
+// the whole proleptic Gregorian calendar without allocation or exceptions.
+
+#include <cstdint>
+#include <vector>
+
+// Epi week structure
+struct epiweek_t {
+    int year;
+    int week;
+};
+
+struct civil_t {
+    int year;
+    unsigned month;
+    unsigned day;
+};
+
+constexpr int32_t days_from_civil(int y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int era      = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int32_t>(doe) - 719468;
+}
+
+constexpr civil_t civil_from_days(int32_t z) {
+    z += 719468;
+    const int32_t era  = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp  = (5 * doy + 2) / 153;
+    const unsigned d   = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned m   = mp < 10 ? mp + 3 : mp - 9;
+    return {static_cast<int>(yoe) + era * 400 + (m <= 2), m, d};
+}
+
+constexpr bool is_leap_year(int y) { return y % 4 == 0 && (y % 100 != 0 || y % 400 == 0); }
+
+constexpr unsigned days_in_month(int y, unsigned m) {
+    return m == 2 ? 28 + is_leap_year(y) : 30 + ((m + (m > 7)) & 1);
+}
+
+// Sunday is 0, as in boost::gregorian
+constexpr int weekday_from_days(int32_t z) { return z >= -4 ? (z + 4) % 7 : (z + 5) % 7 + 6; }
+
+// January 1st is 1
+constexpr int day_of_year(int32_t z) {
+    return z - days_from_civil(civil_from_days(z).year, 1, 1) + 1;
+}
+
+// Years accepted as valid dates, the range of boost::gregorian that this replaced
+const int DATE_MIN_YEAR     = 1400;
+const int DATE_MAX_YEAR     = 9999;
+const int32_t DATE_MIN_DAYS = days_from_civil(DATE_MIN_YEAR, 1, 1);
+const int32_t DATE_MAX_DAYS = days_from_civil(DATE_MAX_YEAR, 12, 31);
+
+constexpr bool is_valid_days(int32_t z) { return z >= DATE_MIN_DAYS && z <= DATE_MAX_DAYS; }
+
+// Day number of January 1st for each valid year and the year after, so that a year's length is
+// the difference of neighbouring entries
+inline std::vector<int32_t> make_year_start_table() {
+    std::vector<int32_t> table(DATE_MAX_YEAR - DATE_MIN_YEAR + 2);
+    for (int y = DATE_MIN_YEAR; y <= DATE_MAX_YEAR + 1; y++) {
+        table[y - DATE_MIN_YEAR] = days_from_civil(y, 1, 1);
+    }
+    return table;
+}
+static const std::vector<int32_t> YEAR_START_TABLE = make_year_start_table();
+
+inline int32_t year_start(int year) { return YEAR_START_TABLE[year - DATE_MIN_YEAR]; }
+
+// The year of a valid day, estimated from the mean Gregorian year and corrected by one at most
+inline int year_from_days(int32_t z) {
+    int year = DATE_MIN_YEAR + static_cast<int>((int64_t(z) - DATE_MIN_DAYS) * 400 / 146097);
+    if (z < year_start(year)) {
+        year--;
+    } else if (z >= year_start(year + 1)) {
+        year++;
+    }
+    return year;
+}
+
+// The Saturday ending the week (Sunday to Saturday) of the day
+constexpr int32_t saturday_ending(int32_t z) { return z + 6 - weekday_from_days(z); }
+
+// Calculation inspired by work from C. Paden: two-week periods are counted back from the Saturday
+// after the last representable date, which is always later than the day. The legacy default moves
+// the period ends one week later.
+const int32_t FINAL_SATURDAY = DATE_MAX_DAYS + 1;
+
+constexpr int32_t fortnight_ending(int32_t z, bool legacy_default_week) {
+    return z + (FINAL_SATURDAY - z + (legacy_default_week ? 7 : 0)) % 14;
+}
+
+// Periods of any length end on the anchor and every period_days before or after it. The anchor is
+// moved to the first such end on or after the last valid date so that each valid day reaches its
+// period end with a single modulo, as fortnight_ending does from FINAL_SATURDAY.
+struct period_t {
+    int64_t days;
+    int64_t last_end;
+};
+
+// Longer periods would put period ends past the range of int32_t days, and every valid day would
+// share one period anyway
+constexpr bool is_valid_period(int32_t period_days) {
+    return period_days > 0 && period_days <= DATE_MAX_DAYS - DATE_MIN_DAYS;
+}
+
+constexpr period_t make_period(int32_t period_days, int32_t anchor) {
+    const int64_t shift = (static_cast<int64_t>(anchor) - DATE_MAX_DAYS) % period_days;
+    return {period_days, DATE_MAX_DAYS + (shift < 0 ? shift + period_days : shift)};
+}
+
+constexpr int32_t period_ending(int32_t z, const period_t &period) {
+    return z + static_cast<int32_t>((period.last_end - z) % period.days);
+}
+
+// Epi (MMWR) weeks run Sunday to Saturday and week 1 is the first with four or more days in the
+// year, i.e., the week holding January 4th.
+// See: https://wwwn.cdc.gov/nndss/document/MMWR_Week_overview.pdf
+constexpr int32_t epiweek_start(int year) {
+    const int32_t jan4 = days_from_civil(year, 1, 4);
+    return jan4 - weekday_from_days(jan4);
+}
+
+constexpr epiweek_t compute_epiweek(int32_t z) {
+    int year = civil_from_days(z).year;
+    if (z >= epiweek_start(year + 1)) {
+        year++;
+    } else if (z < epiweek_start(year)) {
+        year--;
+    }
+    return {year, (z - epiweek_start(year)) / 7 + 1};
+}
+
+// Epi weeks of 1900-01-01 to 2100-12-31 are looked up from a table built at load time, packed
+// as the year past EPIWEEK_TABLE_YEAR in the high bits and the week in the low six.
+const int32_t EPIWEEK_TABLE_FIRST = days_from_civil(1900, 1, 1);
+const int32_t EPIWEEK_TABLE_LAST  = days_from_civil(2100, 12, 31);
+const int EPIWEEK_TABLE_YEAR      = 1899;
+
+inline std::vector<uint16_t> make_epiweek_table() {
+    std::vector<uint16_t> table(EPIWEEK_TABLE_LAST - EPIWEEK_TABLE_FIRST + 1);
+    for (int32_t z = EPIWEEK_TABLE_FIRST; z <= EPIWEEK_TABLE_LAST; z++) {
+        const epiweek_t epi            = compute_epiweek(z);
+        table[z - EPIWEEK_TABLE_FIRST] = ((epi.year - EPIWEEK_TABLE_YEAR) << 6) | epi.week;
+    }
+    return table;
+}
+static const std::vector<uint16_t> EPIWEEK_TABLE = make_epiweek_table();
+
+inline epiweek_t days_to_epiweek(int32_t z) {
+    if (z < EPIWEEK_TABLE_FIRST || z > EPIWEEK_TABLE_LAST) {
+        return compute_epiweek(z);
+    }
+    const uint16_t packed = EPIWEEK_TABLE[z - EPIWEEK_TABLE_FIRST];
+    return {EPIWEEK_TABLE_YEAR + (packed >> 6), packed & 0x3F};
+}
@@ -0,0 +1,123 @@
+// Non-cryptographic 128-bit fingerprints used by the *_fingerprint functions.
+//
+// The construction follows XXH3 (https://github.com/Cyan4973/xxHash): eight 64-bit accumulators
+// each take one word of a 64-byte stripe, mixing it with a secret word through a 32x32->64 bit
+// multiply that the compiler vectorizes. The accumulators are scrambled after every block of 16
+// stripes and folded into two 64-bit halves with 128-bit multiplies at the end. A trailing partial
+// stripe is zero-padded; the total length enters the final mix. Values are NOT compatible with
+// XXH3 itself and must never be used where a cryptographic hash is required.
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+const std::size_t FP_STRIPE        = 64;
+const std::size_t FP_LANES         = 8;
+const std::size_t FP_SECRET_WORDS  = 24;
+const std::size_t FP_BLOCK_STRIPES = FP_SECRET_WORDS - FP_LANES;
+
+const uint64_t FP_PRIME32_1 = 0x9E3779B1ULL;
+const uint64_t FP_PRIME32_2 = 0x85EBCA77ULL;
+const uint64_t FP_PRIME32_3 = 0xC2B2AE3DULL;
+const uint64_t FP_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+const uint64_t FP_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t FP_PRIME64_3 = 0x165667B19E3779F9ULL;
+const uint64_t FP_PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t FP_PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+// 192-byte secret drawn from a splitmix64 sequence
+constexpr std::array<uint64_t, FP_SECRET_WORDS> FP_SECRET = []() {
+    std::array<uint64_t, FP_SECRET_WORDS> s{};
+    uint64_t x = FP_PRIME64_1;
+    for (std::size_t i = 0; i < FP_SECRET_WORDS; i++) {
+        x += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = x;
+        z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z          = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        s[i]       = z ^ (z >> 31);
+    }
+    return s;
+}();
+
+inline uint64_t fp_mul128_fold64(uint64_t a, uint64_t b) {
+    const __uint128_t product = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+}
+
+inline uint64_t fp_avalanche(uint64_t h) {
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ULL;
+    h ^= h >> 32;
+    return h;
+}
+
+class Fingerprint128 {
+  public:
+    void update(const uint8_t *data, std::size_t n) {
+        length += n;
+        if (buffered > 0) {
+            const std::size_t take = std::min(n, FP_STRIPE - buffered);
+            memcpy(buffer + buffered, data, take);
+            buffered += take;
+            data += take;
+            n -= take;
+            if (buffered < FP_STRIPE) {
+                return;
+            }
+            accumulate(buffer);
+            buffered = 0;
+        }
+        for (; n >= FP_STRIPE; data += FP_STRIPE, n -= FP_STRIPE) {
+            accumulate(data);
+        }
+        memcpy(buffer, data, n);
+        buffered = n;
+    }
+
+    // Returns the (high, low) halves; the object should not be updated afterwards
+    std::pair<uint64_t, uint64_t> digest() {
+        if (buffered > 0) {
+            memset(buffer + buffered, 0, FP_STRIPE - buffered);
+            accumulate(buffer);
+        }
+
+        uint64_t low  = length * FP_PRIME64_1;
+        uint64_t high = ~(length * FP_PRIME64_2);
+        for (std::size_t i = 0; i < FP_LANES; i += 2) {
+            low += fp_mul128_fold64(acc[i] ^ FP_SECRET[i + 3], acc[i + 1] ^ FP_SECRET[i + 4]);
+            high += fp_mul128_fold64(acc[i] ^ FP_SECRET[i + 13], acc[i + 1] ^ FP_SECRET[i + 14]);
+        }
+        return {fp_avalanche(high), fp_avalanche(low)};
+    }
+
+  private:
+    void accumulate(const uint8_t *stripe) {
+        uint64_t words[FP_LANES];
+        memcpy(words, stripe, FP_STRIPE);
+
+        const uint64_t *secret = FP_SECRET.data() + stripes;
+        for (std::size_t i = 0; i < FP_LANES; i++) {
+            const uint64_t key = words[i] ^ secret[i];
+            acc[i ^ 1] += words[i];
+            acc[i] += (key & 0xFFFFFFFFULL) * (key >> 32);
+        }
+
+        if (++stripes == FP_BLOCK_STRIPES) {
+            for (std::size_t i = 0; i < FP_LANES; i++) {
+                acc[i] ^= acc[i] >> 47;
+                acc[i] ^= FP_SECRET[FP_BLOCK_STRIPES + i];
+                acc[i] *= FP_PRIME32_1;
+            }
+            stripes = 0;
+        }
+    }
+
+    uint64_t acc[FP_LANES] = {FP_PRIME32_3, FP_PRIME64_1, FP_PRIME64_2, FP_PRIME64_3,
+                              FP_PRIME64_4, FP_PRIME32_2, FP_PRIME64_5, FP_PRIME32_1};
+    uint8_t buffer[FP_STRIPE];
+    std::size_t buffered = 0;
+    std::size_t stripes  = 0;
+    uint64_t length      = 0;
+};
@@ -1,6 +1,10 @@
 // Samuel S. Shepard, CDC
 
+#include <cctype>
 #include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
 #include <map>
 #include <set>
 #include <string>
@@ -10,25 +14,152 @@
 #include <boost/spirit/include/karma.hpp>
 #include <impala_udf/udf.h>
 
-// SPLIT STRING/VIEW by substring (uses search)
-// Modified from: https://github.com/fenbf/StringViewTests/blob/master/StringViewTest.cpp
+// Finds the next occurrence of a delimiter substring: a single byte goes straight to memchr, longer
+// delimiters use memchr on their first byte and compare the rest. Built once per delimiter.
+class SubstrSearcher {
+  public:
+    explicit SubstrSearcher(std::string_view delim) : delim(delim) {}
+
+    std::size_t find(std::string_view str, std::size_t pos) const {
+        const std::size_t LD = delim.size();
+        if (LD == 0 || str.size() < LD) {
+            return std::string_view::npos;
+        }
+
+        const char *data = str.data();
+        const char *last = data + str.size() - LD + 1;
+        for (const char *p = data + pos; p < last; p++) {
+            p = static_cast<const char *>(memchr(p, delim[0], last - p));
+            if (p == NULL) {
+                break;
+            }
+            if (memcmp(p + 1, delim.data() + 1, LD - 1) == 0) {
+                return p - data;
+            }
+        }
+        return std::string_view::npos;
+    }
+
+    std::size_t length() const { return delim.size(); }
+
+  private:
+    std::string_view delim;
+};
+
+// Finds the next byte that is any of a set of single-character delimiters
+class AnyOfSearcher {
+  public:
+    explicit AnyOfSearcher(std::string_view delims) {
+        for (char c : delims) {
+            is_delim[static_cast<uint8_t>(c)] = true;
+        }
+    }
+
+    std::size_t find(std::string_view str, std::size_t pos) const {
+        for (std::size_t i = pos; i < str.size(); i++) {
+            if (is_delim[static_cast<uint8_t>(str[i])]) {
+                return i;
+            }
+        }
+        return std::string_view::npos;
+    }
+
+    std::size_t length() const { return 1; }
+
+  private:
+    bool is_delim[256] = {};
+};
+
+// Lazily yields the non-empty tokens of a string between delimiters, so a list can be walked (and
+// abandoned early) without building a vector. The string must outlive the tokens.
+template <typename Searcher> class TokenRange {
+  public:
+    TokenRange(std::string_view str, Searcher searcher) : str(str), searcher(searcher) {}
+
+    class iterator {
+      public:
+        iterator(const TokenRange *range) : range(range) { advance(0); }
+
+        std::string_view operator*() const { return range->str.substr(start, stop - start); }
+
+        iterator &operator++() {
+            advance(stop + range->searcher.length());
+            return *this;
+        }
+
+        bool operator==(std::default_sentinel_t) const { return start >= range->str.size(); }
+
+      private:
+        void advance(std::size_t pos) {
+            const std::string_view str = range->str;
+            while (pos < str.size()) {
+                std::size_t next = range->searcher.find(str, pos);
+                if (next == std::string_view::npos) {
+                    next = str.size();
+                }
+                if (next > pos) {
+                    start = pos;
+                    stop  = next;
+                    return;
+                }
+                pos = next + range->searcher.length();
+            }
+            start = str.size();
+        }
+
+        const TokenRange *range;
+        std::size_t start = 0;
+        std::size_t stop  = 0;
+    };
+
+    iterator begin() const { return iterator(this); }
+    std::default_sentinel_t end() const { return std::default_sentinel; }
+
+  private:
+    std::string_view str;
+    Searcher searcher;
+};
+
+inline TokenRange<SubstrSearcher> tokens_by_substr(std::string_view str, std::string_view delim) {
+    return TokenRange<SubstrSearcher>(str, SubstrSearcher(delim));
+}
+
+inline TokenRange<AnyOfSearcher> tokens_by_delims(std::string_view str, std::string_view delims) {
+    return TokenRange<AnyOfSearcher>(str, AnyOfSearcher(delims));
+}
+
+// Reads an integer token the way the split_int helpers do: a numeric prefix is enough
+inline bool parse_int_token(std::string_view token, int &value) {
+    return std::from_chars(token.data(), token.data() + token.size(), value).ec == std::errc();
+}
+
+// Reads "a<delim>b" or "a" into values, returning how many integers were read or 0 if any token
+// is not numeric. A third token is counted but not stored.
+inline int parse_int_range(std::string_view str, std::string_view delim, int values[2]) {
+    int count = 0;
+    for (std::string_view token : tokens_by_substr(str, delim)) {
+        int value;
+        if (!parse_int_token(token, value)) {
+            return 0;
+        }
+        if (count < 2) {
+            values[count] = value;
+        }
+        count++;
+    }
+    return count;
+}
+
+// SPLIT STRING/VIEW by substring
 // The lifeime of the input 'str' must be greater than or equal to the lifetime of elements in the
 // output
 inline std::vector<std::string_view> split_by_substr(
     std::string_view str, std::string_view delim_str
 ) {
-    const std::size_t LD = delim_str.size();
     std::vector<std::string_view> output;
-    for (auto first = str.data(), second = str.data(), last = first + str.size();
-         second != last && first != last; first = second + LD) {
-
-        second = std::search(first, last, std::cbegin(delim_str), std::cend(delim_str));
-
-        if (first != second) {
-            output.emplace_back(first, second - first);
-        }
+    for (std::string_view token : tokens_by_substr(str, delim_str)) {
+        output.emplace_back(token);
     }
-
     return output;
 }
 
@@ -37,73 +168,42 @@ inline BooleanVal character_in_string(const StringVal &needle, const StringVal &
         return BooleanVal(false);
     }
 
-    const char query = *needle.ptr;
-    std::string items((const char *)list_of_items.ptr, list_of_items.len);
-    return BooleanVal(items.find(query) != std::string::npos);
+    return BooleanVal(memchr(list_of_items.ptr, *needle.ptr, list_of_items.len) != NULL);
 }
 
 inline std::vector<std::string> split_by_substr(
     const std::string &str, const std::string &delim_str
 ) {
-    const std::size_t LD = delim_str.size();
     std::vector<std::string> output;
-    for (auto first = str.data(), second = str.data(), last = first + str.size();
-         second != last && first != last; first = second + LD) {
-
-        second = std::search(first, last, std::cbegin(delim_str), std::cend(delim_str));
-
-        if (first != second) {
-            output.emplace_back(first, second - first);
-        }
+    for (std::string_view token : tokens_by_substr(str, delim_str)) {
+        output.emplace_back(token);
     }
-
     return output;
 }
 
 
-// SPLIT STRING/VIEW by string of single delimiters (uses find_first_of)
-// Courtesy: https://github.com/fenbf/StringViewTests/blob/master/StringViewTest.cpp
+// SPLIT STRING/VIEW by string of single delimiters
 // The lifeime of the input 'str' must be greater than or equal to the lifetime of elements in the
 // output
 inline auto split_by_delims(std::string_view str, std::string_view delims) {
     std::vector<std::string_view> output;
-    for (auto first = str.data(), second = str.data(), last = first + str.size();
-         second != last && first != last; first = second + 1) {
-
-        second = std::find_first_of(first, last, std::cbegin(delims), std::cend(delims));
-
-        if (first != second) {
-            output.emplace_back(first, second - first);
-        }
+    for (std::string_view token : tokens_by_delims(str, delims)) {
+        output.emplace_back(token);
     }
-
     return output;
 }
 
-// SPLIT STRING/VIEW by substring (uses search)
-// Modified from:
-// https://stackoverflow.com/questions/56634507/safely-convert-stdstring-view-to-int-like-stoi-or-atoi
+// SPLIT STRING/VIEW by substring into integers, returning none if any token is not numeric
 inline std::vector<int> split_int_by_substr(std::string_view str, std::string_view delims) {
-    const std::size_t ND = delims.size();
     std::vector<int> output;
-
-    for (auto first = str.data(), second = str.data(), last = first + str.size();
-         second != last && first != last; first = second + ND) {
-
-        second = std::search(first, last, std::cbegin(delims), std::cend(delims));
-
-        if (first != second) {
-            int ivalue;
-            auto conversion_result = std::from_chars(first, first + (second - first), ivalue);
-            if (conversion_result.ec != std::errc::invalid_argument) {
-                output.emplace_back(ivalue);
-            } else {
-                output.clear();
-                return output;
-            }
+    for (std::string_view token : tokens_by_substr(str, delims)) {
+        int ivalue;
+        if (!parse_int_token(token, ivalue)) {
+            output.clear();
+            return output;
         }
+        output.emplace_back(ivalue);
     }
-
     return output;
 }
 
@@ -241,3 +341,114 @@ inline StringVal to_StringVal(FunctionContext *context, const std::string &s) {
 inline bool append_int(std::string &s, std::size_t val) {
     return boost::spirit::karma::generate(std::back_inserter(s), val);
 }
+
+// Splits a date on '-', '/' or '.' without allocating. The first three fields are written to
+// `fields` and the total number of fields is returned, counted as boost::split would.
+inline std::size_t split_date_fields(std::string_view date, std::string_view fields[3]) {
+    std::size_t count = 0;
+    std::size_t start = 0;
+    while (true) {
+        const std::size_t end = date.find_first_of("-/.", start);
+        if (count < 3) {
+            fields[count] = date.substr(start, end == std::string_view::npos ? end : end - start);
+        }
+        count++;
+        if (end == std::string_view::npos) {
+            return count;
+        }
+        start = end + 1;
+    }
+}
+
+// Reads a field the way std::stoi does (leading whitespace and a '+' are allowed, trailing text is
+// ignored) but reports failure instead of throwing
+inline bool parse_date_field(std::string_view field, int &value) {
+    std::size_t i = 0;
+    while (i < field.size() && std::isspace(static_cast<unsigned char>(field[i]))) {
+        i++;
+    }
+    if (i < field.size() && field[i] == '+') {
+        i++;
+        if (i < field.size() && field[i] == '-') {
+            return false;
+        }
+    }
+    auto [ptr, ec] = std::from_chars(field.data() + i, field.data() + field.size(), value);
+    return ec == std::errc();
+}
+
+// Parses YYYY[-/.]MM[-/.]DD into days since the Unix epoch, ignoring any further fields. Returns
+// false for malformed dates or dates that do not exist. Requires udx-calendar.h.
+inline bool parse_date_string(std::string_view date, int32_t &days) {
+    std::string_view fields[3];
+    int year, month, day;
+    if (split_date_fields(date, fields) < 3 || !parse_date_field(fields[0], year) ||
+        !parse_date_field(fields[1], month) || !parse_date_field(fields[2], day)) {
+        return false;
+    }
+    if (year < DATE_MIN_YEAR || year > DATE_MAX_YEAR || month < 1 || month > 12 || day < 1 ||
+        day > static_cast<int>(days_in_month(year, month))) {
+        return false;
+    }
+
+    days = days_from_civil(year, month, day);
+    return true;
+}
+
+// Direct-mapped cache of parse_date_string results for tables where a few thousand distinct date
+// strings cover millions of rows. Slots are probed linearly a few at a time and the home slot is
+// overwritten when they are all taken, so memory stays at DATE_CACHE_SLOTS slots. Strings longer
+// than a slot's key are parsed without caching.
+const std::size_t DATE_CACHE_SLOTS  = 8192;
+const std::size_t DATE_CACHE_KEY    = 23;
+const std::size_t DATE_CACHE_PROBES = 4;
+
+class DateParseCache {
+  public:
+    bool parse(std::string_view date, int32_t &days) {
+        if (date.empty() || date.size() > DATE_CACHE_KEY) {
+            misses++;
+            return parse_date_string(date, days);
+        }
+
+        // FNV-1a
+        uint64_t h = 0xCBF29CE484222325ULL;
+        for (char c : date) {
+            h = (h ^ static_cast<uint8_t>(c)) * 0x100000001B3ULL;
+        }
+
+        Slot *slot = &slots[h & (DATE_CACHE_SLOTS - 1)];
+        for (std::size_t p = 0; p < DATE_CACHE_PROBES; p++) {
+            Slot &probe = slots[(h + p) & (DATE_CACHE_SLOTS - 1)];
+            if (probe.len == date.size() && memcmp(probe.key, date.data(), date.size()) == 0) {
+                hits++;
+                days = probe.days;
+                return probe.valid;
+            }
+            if (probe.len == 0) {
+                slot = &probe;
+                break;
+            }
+        }
+
+        misses++;
+        slot->valid = parse_date_string(date, slot->days);
+        slot->len   = date.size();
+        memcpy(slot->key, date.data(), date.size());
+        days = slot->days;
+        return slot->valid;
+    }
+
+    uint64_t hits   = 0;
+    uint64_t misses = 0;
+
+  private:
+    struct Slot {
+        uint8_t len = 0;
+        bool valid  = false;
+        char key[DATE_CACHE_KEY];
+        int32_t days = 0;
+    };
+
+    std::vector<Slot> slots = std::vector<Slot>(DATE_CACHE_SLOTS);
+};
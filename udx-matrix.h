@@ -1,6 +1,8 @@
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstdint>
+#include <limits>
 #include <unordered_map>
 using namespace std;
 
@@ -366,54 +368,43 @@ constexpr auto init_ntd() {
 // Nucleotide Distance Matrix
 constexpr auto NTD = init_ntd();
 
-// Nucleotide distance matrix
-constexpr auto init_nt_diff() {
-    std::array<std::array<char, 256>, 256> ntd;
-    for (auto &inner : ntd) {
-        inner.fill('?');
+// Sums NTD over the first `length` sites. Gives up once the running distance reaches `bound`
+// (checked every 64 sites), in which case the returned value is at least `bound`.
+inline int nt_distance_bounded(
+    const uint8_t *seq1, const uint8_t *seq2, std::size_t length,
+    int bound = std::numeric_limits<int>::max()
+) {
+    int d         = 0;
+    std::size_t i = 0;
+    while (i < length) {
+        const std::size_t block = std::min(length, i + 64);
+        for (; i < block; i++) {
+            d += NTD[seq1[i]][seq2[i]];
+        }
+        if (d >= bound) {
+            break;
+        }
     }
+    return d;
+}
 
-    // Comparable nucleotide codes
-    // Alpha includes null byte
-    const int A             = 33;
-    const char alpha[A + 1] = "acgturyswkmbdhvn-ACGTURYSWKMBDHVN";
-
-    // Nuclotides that are resolvable as equal
-    // See: http://www.bioinformatics.org/sms/iupac.html
-    const int E                   = 58;
-    const char equal_base1[E + 1] = "NNNNNNNNNNNNNNNBBBBBBBDDDDDDDHHHHHHHVVVVVVRRYYYSSWWWKKKMMT";
-    const char equal_base2[E + 1] = "ACGTURYSWKMBDHVCGTUYSKAGTURWKACTUYWMACGRSMAGCTUCGATUGTUACU";
-    uint16_t equal_bases[E]       = {'?'};
+// IUPAC nucleotide bitmasks (A=1, C=2, G=4, T/U=8, gap=16), 0 for anything else. Two nucleotides
+// are resolvably equal when one mask contains the other (e.g., A = R = N but R != S).
+constexpr auto init_nt_iupac_mask() {
+    std::array<uint8_t, 256> mask = {0};
 
-    for (int k = 0; k < E; k++) {
-        uint16_t index = ((uint16_t)equal_base1[k] << 8) | ((uint16_t)equal_base2[k]);
-        equal_bases[k] = index;
-    }
+    const int A             = 17;
+    const char alpha[A + 1] = "ACGTURYSWKMBDHVN-";
+    const uint8_t bits[A]   = {1, 2, 4, 8, 8, 5, 10, 6, 9, 12, 3, 14, 13, 11, 7, 15, 16};
 
     for (int i = 0; i < A; i++) {
-        for (int j = 0; j < A; j++) {
-            char b1                 = to_const_upper(alpha[i]);
-            char b2                 = to_const_upper(alpha[j]);
-            ntd[alpha[i]][alpha[j]] = '.';
-
-            if (b1 != b2) {
-                uint16_t key            = ((uint16_t)b1 << 8) | ((uint16_t)b2);
-                uint16_t rev_key        = ((uint16_t)b2 << 8) | ((uint16_t)b1);
-                ntd[alpha[i]][alpha[j]] = alpha[j];
-
-                for (int k = 0; k < E; k++) {
-                    if (equal_bases[k] == key || equal_bases[k] == rev_key) {
-                        ntd[alpha[i]][alpha[j]] = '.';
-                        break;
-                    }
-                }
-            }
-        }
+        mask[alpha[i]]                 = bits[i];
+        mask[to_const_lower(alpha[i])] = bits[i];
     }
-    return ntd;
+    return mask;
 }
-// Nucleotide Distance Matrix
-constexpr auto NT_DIFF = init_nt_diff();
+// Nucleotide IUPAC Masks
+constexpr auto NT_IUPAC_MASK = init_nt_iupac_mask();
 
 constexpr auto init_rcm() {
     std::array<char, 256> rcm = {0};
@@ -0,0 +1,115 @@
+// Size-bounded, thread-local memo of UDF results for tables where the same inputs repeat (e.g.,
+// one HA sequence across thousands of specimens). Functions opt in by being registered with
+// PREPARE_FN = "Memo_Prepare" and CLOSE_FN = "Memo_Close"; without them the cache is absent and
+// every row is computed as usual. Requires Fingerprint128 from udx-hash.h.
+//
+// Entries hold the full key bytes, so a hash collision is a miss rather than a wrong answer. The
+// least recently used entries are evicted once the byte budget is exceeded.
+
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <impala_udf/udf.h>
+
+const std::size_t MEMO_BUDGET         = 4 * 1024 * 1024;
+const std::size_t MEMO_ENTRY_OVERHEAD = 64;
+
+struct MemoHash {
+    std::size_t operator()(std::string_view key) const {
+        Fingerprint128 fp;
+        fp.update(reinterpret_cast<const uint8_t *>(key.data()), key.size());
+        return fp.digest().second;
+    }
+};
+
+class MemoCache {
+  public:
+    explicit MemoCache(std::size_t budget) : budget(budget) {}
+
+    // Returns the cached value and marks it most recently used, or NULL
+    const std::string *find(const std::string &key) {
+        auto it = index.find(key);
+        if (it == index.end()) {
+            misses++;
+            return NULL;
+        }
+        hits++;
+        lru.splice(lru.begin(), lru, it->second);
+        return &it->second->value;
+    }
+
+    void insert(std::string &&key, std::string_view value) {
+        const std::size_t cost = key.size() + value.size() + MEMO_ENTRY_OVERHEAD;
+        if (cost > budget || index.find(key) != index.end()) {
+            return;
+        }
+
+        while (bytes + cost > budget) {
+            const Entry &last = lru.back();
+            bytes -= last.key.size() + last.value.size() + MEMO_ENTRY_OVERHEAD;
+            index.erase(last.key);
+            lru.pop_back();
+            evictions++;
+        }
+
+        lru.push_front(Entry{std::move(key), std::string(value)});
+        index.emplace(lru.front().key, lru.begin());
+        bytes += cost;
+    }
+
+    uint64_t hits      = 0;
+    uint64_t misses    = 0;
+    uint64_t evictions = 0;
+
+  private:
+    struct Entry {
+        std::string key;
+        std::string value;
+    };
+
+    std::list<Entry> lru;
+    std::unordered_map<std::string_view, std::list<Entry>::iterator, MemoHash> index;
+    std::size_t bytes = 0;
+    std::size_t budget;
+};
+
+// Each argument is length-prefixed so that ("ab", "c") and ("a", "bc") differ
+inline void memo_append_key(std::string &key, const impala_udf::StringVal &arg) {
+    const uint32_t len = arg.len;
+    key.append(reinterpret_cast<const char *>(&len), sizeof(len));
+    key.append(reinterpret_cast<const char *>(arg.ptr), arg.len);
+}
+
+// Returns compute(context, args...) through the thread-local cache when the function was prepared
+// with Memo_Prepare. Null inputs and null results bypass the cache.
+template <typename... Args>
+inline impala_udf::StringVal memoized(
+    impala_udf::FunctionContext *context,
+    impala_udf::StringVal (*compute)(impala_udf::FunctionContext *, const Args &...),
+    const Args &...args
+) {
+    MemoCache *cache = reinterpret_cast<MemoCache *>(
+        context->GetFunctionState(impala_udf::FunctionContext::THREAD_LOCAL)
+    );
+    if (cache == NULL || (args.is_null || ...)) {
+        return compute(context, args...);
+    }
+
+    std::string key;
+    (memo_append_key(key, args), ...);
+    if (const std::string *value = cache->find(key)) {
+        return impala_udf::StringVal::CopyFrom(
+            context, reinterpret_cast<const uint8_t *>(value->data()), value->size()
+        );
+    }
+
+    impala_udf::StringVal result = compute(context, args...);
+    if (!result.is_null) {
+        cache->insert(
+            std::move(key), std::string_view(reinterpret_cast<const char *>(result.ptr), result.len)
+        );
+    }
+    return result;
+}
@@ -0,0 +1,223 @@
+// Multi-buffer SHA1 and MD5 used by the batched nt_id and variant_hash entry points.
+//
+// A single digest is latency-bound because every round depends on the one before it. Here each of
+// MB_LANES independent messages occupies one 32-bit lane of a vector, so one pass of the
+// compression function advances all of them; with -march=cascadelake the lanes map onto AVX-512
+// registers. A lane that finishes its message is refilled with the next one, so messages of
+// different lengths keep the vector busy. Digests are byte-identical to the scalar algorithms.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+const std::size_t MB_LANES = 16;
+const std::size_t MB_BLOCK = 64;
+
+typedef uint32_t mb_vec __attribute__((vector_size(MB_LANES * sizeof(uint32_t))));
+
+inline mb_vec mb_rotl(mb_vec x, int n) { return (x << n) | (x >> (32 - n)); }
+
+struct MultiSHA1 {
+    static const std::size_t WORDS        = 5;
+    static const std::size_t DIGEST_BYTES = 20;
+    static const bool BIG_ENDIAN_WORDS    = true;
+    static constexpr uint32_t IV[WORDS]   = {
+        0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0
+    };
+
+    static void compress(mb_vec state[WORDS], mb_vec w[16]) {
+        mb_vec a = state[0];
+        mb_vec b = state[1];
+        mb_vec c = state[2];
+        mb_vec d = state[3];
+        mb_vec e = state[4];
+
+        // One loop per round function keeps the bodies branch-free
+        auto step = [&](int t, mb_vec f, uint32_t k) {
+            if (t >= 16) {
+                w[t & 15] = mb_rotl(
+                    w[(t - 3) & 15] ^ w[(t - 8) & 15] ^ w[(t - 14) & 15] ^ w[t & 15], 1
+                );
+            }
+            mb_vec temp = mb_rotl(a, 5) + f + e + k + w[t & 15];
+            e           = d;
+            d           = c;
+            c           = mb_rotl(b, 30);
+            b           = a;
+            a           = temp;
+        };
+        for (int t = 0; t < 20; t++) {
+            step(t, (b & c) | (~b & d), 0x5A827999);
+        }
+        for (int t = 20; t < 40; t++) {
+            step(t, b ^ c ^ d, 0x6ED9EBA1);
+        }
+        for (int t = 40; t < 60; t++) {
+            step(t, (b & c) | (b & d) | (c & d), 0x8F1BBCDC);
+        }
+        for (int t = 60; t < 80; t++) {
+            step(t, b ^ c ^ d, 0xCA62C1D6);
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+    }
+};
+
+struct MultiMD5 {
+    static const std::size_t WORDS        = 4;
+    static const std::size_t DIGEST_BYTES = 16;
+    static const bool BIG_ENDIAN_WORDS    = false;
+    static constexpr uint32_t IV[WORDS]   = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476};
+
+    static void compress(mb_vec state[WORDS], mb_vec w[16]) {
+        static constexpr uint32_t K[64] = {
+            0xD76AA478, 0xE8C7B756, 0x242070DB, 0xC1BDCEEE, 0xF57C0FAF, 0x4787C62A, 0xA8304613,
+            0xFD469501, 0x698098D8, 0x8B44F7AF, 0xFFFF5BB1, 0x895CD7BE, 0x6B901122, 0xFD987193,
+            0xA679438E, 0x49B40821, 0xF61E2562, 0xC040B340, 0x265E5A51, 0xE9B6C7AA, 0xD62F105D,
+            0x02441453, 0xD8A1E681, 0xE7D3FBC8, 0x21E1CDE6, 0xC33707D6, 0xF4D50D87, 0x455A14ED,
+            0xA9E3E905, 0xFCEFA3F8, 0x676F02D9, 0x8D2A4C8A, 0xFFFA3942, 0x8771F681, 0x6D9D6122,
+            0xFDE5380C, 0xA4BEEA44, 0x4BDECFA9, 0xF6BB4B60, 0xBEBFBC70, 0x289B7EC6, 0xEAA127FA,
+            0xD4EF3085, 0x04881D05, 0xD9D4D039, 0xE6DB99E5, 0x1FA27CF8, 0xC4AC5665, 0xF4292244,
+            0x432AFF97, 0xAB9423A7, 0xFC93A039, 0x655B59C3, 0x8F0CCC92, 0xFFEFF47D, 0x85845DD1,
+            0x6FA87E4F, 0xFE2CE6E0, 0xA3014314, 0x4E0811A1, 0xF7537E82, 0xBD3AF235, 0x2AD7D2BB,
+            0xEB86D391
+        };
+
+        mb_vec a = state[0];
+        mb_vec b = state[1];
+        mb_vec c = state[2];
+        mb_vec d = state[3];
+
+        // Each round is four steps with fixed rotations, rotating (a, b, c, d) by one per step
+        auto step = [&](int i, mb_vec f, int g, int r) {
+            f = f + a + K[i] + w[g];
+            a = d;
+            d = c;
+            c = b;
+            b = b + mb_rotl(f, r);
+        };
+        for (int i = 0; i < 16; i += 4) {
+            step(i, (b & c) | (~b & d), i, 7);
+            step(i + 1, (b & c) | (~b & d), i + 1, 12);
+            step(i + 2, (b & c) | (~b & d), i + 2, 17);
+            step(i + 3, (b & c) | (~b & d), i + 3, 22);
+        }
+        for (int i = 16; i < 32; i += 4) {
+            step(i, (d & b) | (~d & c), (5 * i + 1) & 15, 5);
+            step(i + 1, (d & b) | (~d & c), (5 * i + 6) & 15, 9);
+            step(i + 2, (d & b) | (~d & c), (5 * i + 11) & 15, 14);
+            step(i + 3, (d & b) | (~d & c), (5 * i + 16) & 15, 20);
+        }
+        for (int i = 32; i < 48; i += 4) {
+            step(i, b ^ c ^ d, (3 * i + 5) & 15, 4);
+            step(i + 1, b ^ c ^ d, (3 * i + 8) & 15, 11);
+            step(i + 2, b ^ c ^ d, (3 * i + 11) & 15, 16);
+            step(i + 3, b ^ c ^ d, (3 * i + 14) & 15, 23);
+        }
+        for (int i = 48; i < 64; i += 4) {
+            step(i, c ^ (b | ~d), (7 * i) & 15, 6);
+            step(i + 1, c ^ (b | ~d), (7 * i + 7) & 15, 10);
+            step(i + 2, c ^ (b | ~d), (7 * i + 14) & 15, 15);
+            step(i + 3, c ^ (b | ~d), (7 * i + 21) & 15, 21);
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+    }
+};
+
+// Blocks in the padded message: the data, a 0x80 byte and the 64-bit bit length
+inline std::size_t mb_block_count(std::size_t len) { return (len + 8) / MB_BLOCK + 1; }
+
+// Writes block b of the padded message into the lane's column of the transposed words
+template <typename Hash>
+inline void mb_load_block(
+    std::string_view msg, std::size_t b, std::size_t lane, uint32_t words[16][MB_LANES]
+) {
+    const std::size_t len    = msg.size();
+    const std::size_t offset = b * MB_BLOCK;
+
+    // Full blocks are read in place, only the tail is copied out for padding
+    uint8_t block[MB_BLOCK];
+    const uint8_t *src = reinterpret_cast<const uint8_t *>(msg.data()) + offset;
+    if (offset + MB_BLOCK > len) {
+        const std::size_t take = offset < len ? len - offset : 0;
+        memcpy(block, src, take);
+        memset(block + take, 0, MB_BLOCK - take);
+        if (offset <= len) {
+            block[len - offset] = 0x80;
+        }
+        if (b + 1 == mb_block_count(len)) {
+            const uint64_t bits = static_cast<uint64_t>(len) * 8;
+            for (int j = 0; j < 8; j++) {
+                block[Hash::BIG_ENDIAN_WORDS ? 63 - j : 56 + j] = bits >> (8 * j);
+            }
+        }
+        src = block;
+    }
+
+    for (int t = 0; t < 16; t++) {
+        uint32_t word;
+        memcpy(&word, src + 4 * t, sizeof(uint32_t));
+        words[t][lane] = Hash::BIG_ENDIAN_WORDS ? __builtin_bswap32(word) : word;
+    }
+}
+
+// Hashes every message, writing Hash::DIGEST_BYTES per message to digests in input order
+template <typename Hash>
+void multibuffer_hash(const std::vector<std::string_view> &messages, uint8_t *digests) {
+    const std::size_t NO_JOB = SIZE_MAX;
+    std::size_t job[MB_LANES];
+    std::size_t block[MB_LANES] = {};
+    std::size_t next            = 0;
+    std::size_t active          = 0;
+
+    mb_vec state[Hash::WORDS];
+    for (std::size_t lane = 0; lane < MB_LANES; lane++) {
+        job[lane] = next < messages.size() ? next++ : NO_JOB;
+        active += job[lane] != NO_JOB;
+        for (std::size_t i = 0; i < Hash::WORDS; i++) {
+            state[i][lane] = Hash::IV[i];
+        }
+    }
+
+    uint32_t words[16][MB_LANES] = {};
+    mb_vec w[16];
+    while (active > 0) {
+        for (std::size_t lane = 0; lane < MB_LANES; lane++) {
+            if (job[lane] != NO_JOB) {
+                mb_load_block<Hash>(messages[job[lane]], block[lane], lane, words);
+            }
+        }
+
+        memcpy(w, words, sizeof(w));
+        Hash::compress(state, w);
+
+        for (std::size_t lane = 0; lane < MB_LANES; lane++) {
+            if (job[lane] == NO_JOB || ++block[lane] < mb_block_count(messages[job[lane]].size())) {
+                continue;
+            }
+
+            uint8_t *out = digests + job[lane] * Hash::DIGEST_BYTES;
+            for (std::size_t i = 0; i < Hash::WORDS; i++) {
+                const uint32_t v = state[i][lane];
+                for (int j = 0; j < 4; j++) {
+                    out[4 * i + j] = v >> (Hash::BIG_ENDIAN_WORDS ? 24 - 8 * j : 8 * j);
+                }
+                state[i][lane] = Hash::IV[i];
+            }
+
+            block[lane] = 0;
+            job[lane]   = next < messages.size() ? next++ : NO_JOB;
+            active -= job[lane] == NO_JOB;
+        }
+    }
+}
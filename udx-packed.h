@@ -0,0 +1,193 @@
+// Packed nucleotide storage used by nt_pack, nt_unpack and the *_packed distance functions.
+//
+// Layout (little-endian):
+//   byte  0      bits per site, 2 or 4
+//   bytes 1..4   number of sites (uint32)
+//   bytes 5..8   number of exceptions (uint32)
+//   data         ceil(sites * bits / 8) bytes, site i at bit offset i * bits
+//   exceptions   (uint32 position, uint8 symbol) for each site the codes cannot represent,
+//                ascending by position
+//
+// 4-bit codes are IUPAC bitmasks (A=1, C=2, G=4, T=8, N=15) with 0 as the gap. 2-bit codes are
+// A=0, C=1, G=2, T=3. Symbols are stored upper-case. Exception sites hold code 0 in the data.
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#include <impala_udf/udf.h>
+
+const std::size_t PACKED_HEADER    = 9;
+const std::size_t PACKED_EXCEPTION = 5;
+const uint8_t PACKED_NO_CODE       = 255;
+
+const char FROM_NT4[] = "-ACMGRSVTWYHKDBN";
+const char FROM_NT2[] = "ACGT";
+
+constexpr std::array<uint8_t, 256> TO_NT4 = []() {
+    std::array<uint8_t, 256> v{};
+    v.fill(PACKED_NO_CODE);
+    for (uint8_t code = 0; code < 16; code++) {
+        v[FROM_NT4[code]] = code;
+        if (FROM_NT4[code] >= 'A' && FROM_NT4[code] <= 'Z') {
+            v[FROM_NT4[code] - 'A' + 'a'] = code;
+        }
+    }
+    return v;
+}();
+
+constexpr std::array<uint8_t, 256> TO_NT2 = []() {
+    std::array<uint8_t, 256> v{};
+    v.fill(PACKED_NO_CODE);
+    for (uint8_t code = 0; code < 4; code++) {
+        v[FROM_NT2[code]]             = code;
+        v[FROM_NT2[code] - 'A' + 'a'] = code;
+    }
+    return v;
+}();
+
+// TN-93 profile index (A, C, G, T, other) for each 4-bit code
+constexpr std::array<uint8_t, 16> NT4_TO_PROFILE_INDEX = {4, 0, 1, 4, 2, 4, 4, 4,
+                                                          3, 4, 4, 4, 4, 4, 4, 4};
+
+struct PackedSeq {
+    uint8_t bits;
+    uint32_t n;
+    uint32_t n_exceptions;
+    const uint8_t *data;
+    const uint8_t *exceptions;
+};
+
+inline std::size_t packed_data_bytes(std::size_t bits, std::size_t n) { return (n * bits + 7) / 8; }
+
+inline uint32_t packed_exception_pos(const PackedSeq &p, uint32_t k) {
+    uint32_t pos;
+    memcpy(&pos, p.exceptions + k * PACKED_EXCEPTION, sizeof(uint32_t));
+    return pos;
+}
+
+// Validates the header and sizes of a packed StringVal, and that exception positions are sites in
+// strictly ascending order as the binary search in packed_symbol requires
+inline bool packed_view(const impala_udf::StringVal &val, PackedSeq &p) {
+    if (val.is_null || static_cast<std::size_t>(val.len) < PACKED_HEADER) {
+        return false;
+    }
+
+    p.bits = val.ptr[0];
+    memcpy(&p.n, val.ptr + 1, sizeof(uint32_t));
+    memcpy(&p.n_exceptions, val.ptr + 5, sizeof(uint32_t));
+    if (p.bits != 2 && p.bits != 4) {
+        return false;
+    }
+
+    std::size_t data_bytes = packed_data_bytes(p.bits, p.n);
+    if (static_cast<std::size_t>(val.len) !=
+        PACKED_HEADER + data_bytes + PACKED_EXCEPTION * static_cast<std::size_t>(p.n_exceptions)) {
+        return false;
+    }
+
+    p.data       = val.ptr + PACKED_HEADER;
+    p.exceptions = p.data + data_bytes;
+    for (uint32_t k = 0; k < p.n_exceptions; k++) {
+        const uint32_t pos = packed_exception_pos(p, k);
+        if (pos >= p.n || (k > 0 && pos <= packed_exception_pos(p, k - 1))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline uint8_t packed_exception_sym(const PackedSeq &p, uint32_t k) {
+    return p.exceptions[k * PACKED_EXCEPTION + sizeof(uint32_t)];
+}
+
+inline uint8_t packed_code(const PackedSeq &p, std::size_t i) {
+    const std::size_t bit = i * p.bits;
+    return (p.data[bit / 8] >> (bit % 8)) & ((1 << p.bits) - 1);
+}
+
+// Symbol at site i, consulting the exception list (binary search)
+inline uint8_t packed_symbol(const PackedSeq &p, std::size_t i) {
+    uint32_t lo = 0;
+    uint32_t hi = p.n_exceptions;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (packed_exception_pos(p, mid) < i) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo < p.n_exceptions && packed_exception_pos(p, lo) == i) {
+        return packed_exception_sym(p, lo);
+    }
+
+    const uint8_t code = packed_code(p, i);
+    return p.bits == 4 ? FROM_NT4[code] : FROM_NT2[code];
+}
+
+// Loads the w-th 64-bit word of data with sites at or beyond `n` zeroed
+inline uint64_t packed_word(const PackedSeq &p, std::size_t w, std::size_t n) {
+    const std::size_t lanes = 64 / p.bits;
+    const std::size_t first = w * lanes;
+    const std::size_t bytes = std::min(packed_data_bytes(p.bits, n) - w * 8, std::size_t(8));
+
+    uint64_t word = 0;
+    memcpy(&word, p.data + w * 8, bytes);
+    if (n - first < lanes) {
+        word &= (uint64_t(1) << ((n - first) * p.bits)) - 1;
+    }
+    return word;
+}
+
+const uint64_t LANE4 = 0x1111111111111111ULL;
+const uint64_t LANE2 = 0x5555555555555555ULL;
+
+// Flags (low bit of each lane) for non-zero lanes
+inline uint64_t nonzero_lanes4(uint64_t x) { return (x | x >> 1 | x >> 2 | x >> 3) & LANE4; }
+inline uint64_t nonzero_lanes2(uint64_t x) { return (x | x >> 1) & LANE2; }
+
+// Flags lanes equal to the broadcast code
+inline uint64_t equal_lanes4(uint64_t x, uint64_t code) {
+    uint64_t m = ~(x ^ (LANE4 * code));
+    return m & m >> 1 & m >> 2 & m >> 3 & LANE4;
+}
+inline uint64_t equal_lanes2(uint64_t x, uint64_t code) {
+    uint64_t m = ~(x ^ (LANE2 * code));
+    return m & m >> 1 & LANE2;
+}
+
+// NTD on 4-bit codes: gaps only equal gaps, otherwise bases are equal when one IUPAC set contains
+// the other (e.g., A = R = N but R != S).
+inline uint64_t ntd_lanes4(uint64_t a, uint64_t b) {
+    const uint64_t inter    = a & b;
+    const uint64_t a_subset = ~nonzero_lanes4(inter ^ a) & LANE4;
+    const uint64_t b_subset = ~nonzero_lanes4(inter ^ b) & LANE4;
+    const uint64_t a_gap    = ~nonzero_lanes4(a) & LANE4;
+    const uint64_t b_gap    = ~nonzero_lanes4(b) & LANE4;
+    return (~(a_subset | b_subset) & LANE4) | (a_gap ^ b_gap);
+}
+
+inline int ntd_code4(uint8_t a, uint8_t b) { return static_cast<int>(ntd_lanes4(a, b) & 1); }
+
+// Calls visit(position) once for each site below n that is an exception in either sequence
+template <typename F>
+inline void packed_exceptions_union(
+    const PackedSeq &p1, const PackedSeq &p2, std::size_t n, F &&visit
+) {
+    uint32_t i = 0;
+    uint32_t j = 0;
+    while (i < p1.n_exceptions || j < p2.n_exceptions) {
+        uint32_t pos1 = i < p1.n_exceptions ? packed_exception_pos(p1, i) : UINT32_MAX;
+        uint32_t pos2 = j < p2.n_exceptions ? packed_exception_pos(p2, j) : UINT32_MAX;
+        uint32_t pos  = std::min(pos1, pos2);
+        if (pos >= n) {
+            break;
+        }
+        visit(pos);
+        i += (pos1 == pos);
+        j += (pos2 == pos);
+    }
+}
@@ -0,0 +1,147 @@
+// Bottom-s MinHash sketches of canonical nucleotide k-mers used by nt_sketch, sketch_similarity,
+// sketch_distance and the sketch_union aggregate. Requires RCM from udx-matrix.h.
+//
+// Layout (little-endian):
+//   byte  0      k-mer length, 1 to 32
+//   bytes 1..4   sketch size s (uint32)
+//   hashes       up to s distinct uint64 k-mer hashes in ascending order
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <set>
+#include <vector>
+
+#include <impala_udf/udf.h>
+
+const std::size_t SKETCH_HEADER = 5;
+const uint8_t SKETCH_NO_CODE    = 255;
+const uint8_t SKETCH_MAX_K      = 32;
+const uint32_t SKETCH_DEFAULT_S = 1000;
+const uint8_t SKETCH_DEFAULT_K  = 21;
+
+// 2-bit k-mer codes, U is read as T
+constexpr std::array<uint8_t, 256> TO_KMER_CODE = []() {
+    std::array<uint8_t, 256> v{};
+    v.fill(SKETCH_NO_CODE);
+    const char bases[]   = "ACGTUacgtu";
+    const uint8_t code[] = {0, 1, 2, 3, 3, 0, 1, 2, 3, 3};
+    for (int i = 0; i < 10; i++) {
+        v[bases[i]] = code[i];
+    }
+    return v;
+}();
+
+struct SketchView {
+    uint8_t k;
+    uint32_t s;
+    uint32_t n;
+    const uint8_t *hashes;
+};
+
+inline bool sketch_view(const impala_udf::StringVal &val, SketchView &v) {
+    if (val.is_null || static_cast<std::size_t>(val.len) < SKETCH_HEADER ||
+        (val.len - SKETCH_HEADER) % sizeof(uint64_t) != 0) {
+        return false;
+    }
+
+    v.k = val.ptr[0];
+    memcpy(&v.s, val.ptr + 1, sizeof(uint32_t));
+    v.n      = (val.len - SKETCH_HEADER) / sizeof(uint64_t);
+    v.hashes = val.ptr + SKETCH_HEADER;
+    return v.k > 0 && v.k <= SKETCH_MAX_K && v.s > 0 && v.n <= v.s;
+}
+
+inline uint64_t sketch_hash(const SketchView &v, uint32_t i) {
+    uint64_t h;
+    memcpy(&h, v.hashes + i * sizeof(uint64_t), sizeof(uint64_t));
+    return h;
+}
+
+inline std::size_t sketch_bytes(std::size_t n) { return SKETCH_HEADER + n * sizeof(uint64_t); }
+
+inline void write_sketch(uint8_t *out, uint8_t k, uint32_t s, const std::vector<uint64_t> &hashes) {
+    out[0] = k;
+    memcpy(out + 1, &s, sizeof(uint32_t));
+    memcpy(out + SKETCH_HEADER, hashes.data(), hashes.size() * sizeof(uint64_t));
+}
+
+// splitmix64 finalizer, a bijection so distinct k-mers never collide
+inline uint64_t kmer_hash(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// Hashes of the s smallest distinct canonical k-mers. The forward and reverse complement codes are
+// rolled two bits at a time and any k-mer spanning a non-ACGTU symbol is skipped. Only the s
+// smallest hashes seen so far are kept, so once the set is full most k-mers cost one comparison
+// against its largest hash.
+inline std::vector<uint64_t> sketch_kmers(const uint8_t *seq, std::size_t len, int k, uint32_t s) {
+    if (s == 0) {
+        return {};
+    }
+    const uint64_t mask = k == 32 ? ~uint64_t(0) : (uint64_t(1) << (2 * k)) - 1;
+    const int rc_shift  = 2 * (k - 1);
+    uint64_t forward    = 0;
+    uint64_t reverse    = 0;
+    int valid           = 0;
+
+    std::set<uint64_t> smallest;
+    for (std::size_t i = 0; i < len; i++) {
+        const uint8_t code = TO_KMER_CODE[seq[i]];
+        if (code == SKETCH_NO_CODE) {
+            valid = 0;
+            continue;
+        }
+
+        const uint64_t complement = TO_KMER_CODE[static_cast<uint8_t>(RCM[seq[i]])];
+        forward                   = ((forward << 2) | code) & mask;
+        reverse                   = (reverse >> 2) | (complement << rc_shift);
+        if (++valid < k) {
+            continue;
+        }
+        const uint64_t h = kmer_hash(std::min(forward, reverse));
+        if (smallest.size() < s) {
+            smallest.insert(h);
+        } else if (h < *smallest.rbegin() && smallest.insert(h).second) {
+            smallest.erase(std::prev(smallest.end()));
+        }
+    }
+    return std::vector<uint64_t>(smallest.begin(), smallest.end());
+}
+
+// Walks the bottom-s of the union of two sketches (s is the smaller sketch size). Returns the union
+// hashes taken and sets `shared` to how many of them occur in both sketches.
+inline std::vector<uint64_t> sketch_union(
+    const SketchView &a, const SketchView &b, uint32_t s, uint32_t &shared
+) {
+    std::vector<uint64_t> merged;
+    merged.reserve(std::min(s, a.n + b.n));
+    shared = 0;
+
+    uint32_t i = 0;
+    uint32_t j = 0;
+    while (merged.size() < s && (i < a.n || j < b.n)) {
+        uint64_t ha = i < a.n ? sketch_hash(a, i) : UINT64_MAX;
+        uint64_t hb = j < b.n ? sketch_hash(b, j) : UINT64_MAX;
+        if (i < a.n && j < b.n && ha == hb) {
+            merged.push_back(ha);
+            shared++;
+            i++;
+            j++;
+        } else if (j >= b.n || (i < a.n && ha < hb)) {
+            merged.push_back(ha);
+            i++;
+        } else {
+            merged.push_back(hb);
+            j++;
+        }
+    }
+    return merged;
+}
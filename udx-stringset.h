@@ -0,0 +1,98 @@
+// Open-addressing set of strings used by is_element to test membership in a constant list with a
+// single probe per row. Requires the FP_PRIME64 constants and mixing functions of udx-hash.h.
+//
+// Keys are copied into one pool. Each slot keeps the key's 64-bit hash, offset and length, so a
+// probe only touches the pool when both the hash and the length already match. The table is at
+// most half full and probed linearly; a zero length marks an empty slot.
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+inline uint64_t string_set_hash(std::string_view key) {
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(key.data());
+    std::size_t n          = key.size();
+    uint64_t h             = FP_PRIME64_1 ^ (n * FP_PRIME64_2);
+    while (n >= 8) {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        h = fp_mul128_fold64(h ^ word, FP_PRIME64_3);
+        p += 8;
+        n -= 8;
+    }
+    if (n > 0) {
+        uint64_t word = 0;
+        memcpy(&word, p, n);
+        h = fp_mul128_fold64(h ^ word, FP_PRIME64_4);
+    }
+    return fp_avalanche(h);
+}
+
+class StringSet {
+  public:
+    // Keys is any range of string_view that can be iterated twice; empty keys are ignored
+    template <typename Keys>
+    explicit StringSet(const Keys &keys) {
+        std::size_t count = 0;
+        std::size_t bytes = 0;
+        for (std::string_view key : keys) {
+            count++;
+            bytes += key.size();
+        }
+
+        std::size_t capacity = 16;
+        while (capacity < 2 * count) {
+            capacity *= 2;
+        }
+        mask = capacity - 1;
+        slots.assign(capacity, Slot{0, 0, 0});
+        pool.reserve(bytes);
+
+        for (std::string_view key : keys) {
+            if (key.empty()) {
+                continue;
+            }
+            const uint64_t h = string_set_hash(key);
+            std::size_t i    = h & mask;
+            while (slots[i].length != 0 && !matches(slots[i], h, key)) {
+                i = (i + 1) & mask;
+            }
+            if (slots[i].length == 0) {
+                const uint32_t offset = pool.size();
+                slots[i]              = {h, offset, static_cast<uint32_t>(key.size())};
+                pool.append(key);
+            }
+        }
+    }
+
+    bool contains(std::string_view key) const {
+        if (key.empty()) {
+            return false;
+        }
+        const uint64_t h = string_set_hash(key);
+        for (std::size_t i = h & mask; slots[i].length != 0; i = (i + 1) & mask) {
+            if (matches(slots[i], h, key)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+  private:
+    struct Slot {
+        uint64_t hash;
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    bool matches(const Slot &slot, uint64_t h, std::string_view key) const {
+        return slot.hash == h && slot.length == key.size() &&
+               memcmp(pool.data() + slot.offset, key.data(), key.size()) == 0;
+    }
+
+    std::vector<Slot> slots;
+    std::size_t mask;
+    std::string pool;
+};
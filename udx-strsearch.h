@@ -0,0 +1,100 @@
+// Substring search used by contains_sym and contains_sym_ignore_case.
+//
+// With AVX2, 32 candidate positions are filtered at once by comparing the needle's first byte to
+// the haystack at each position and its last byte to the haystack m - 1 bytes later, following
+// W. Mula's "SIMD-friendly algorithms for substring searching". Only positions where both bytes
+// match are compared in full. The case-insensitive search folds ASCII letters to lower case on
+// both sides. Fewer than 32 positions, and non-AVX2 builds, apply the same filter byte by byte.
+
+#include <cstdint>
+#include <cstring>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+inline uint8_t fold_ascii(uint8_t c) { return c >= 'A' && c <= 'Z' ? c | 0x20 : c; }
+
+template <bool IGNORE_CASE>
+inline bool substring_equal(const uint8_t *a, const uint8_t *b, std::size_t n) {
+    if (!IGNORE_CASE) {
+        return memcmp(a, b, n) == 0;
+    }
+    for (std::size_t i = 0; i < n; i++) {
+        if (fold_ascii(a[i]) != fold_ascii(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef __AVX2__
+template <bool IGNORE_CASE>
+inline __m256i fold_ascii_vector(__m256i v) {
+    if (!IGNORE_CASE) {
+        return v;
+    }
+    // 'A' to 'Z' are shifted to the 26 smallest signed bytes so that one compare finds them
+    const __m256i shifted = _mm256_add_epi8(v, _mm256_set1_epi8(static_cast<char>(0x80 - 'A')));
+    const __m256i upper   = _mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 26), shifted);
+    return _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+#endif
+
+// True if the needle of m bytes occurs in the haystack of n bytes
+template <bool IGNORE_CASE>
+inline bool contains_substring(
+    const uint8_t *haystack, std::size_t n, const uint8_t *needle, std::size_t m
+) {
+    if (m == 0) {
+        return true;
+    } else if (m > n) {
+        return false;
+    }
+
+    const std::size_t positions = n - m + 1;
+    const uint8_t first         = IGNORE_CASE ? fold_ascii(needle[0]) : needle[0];
+    const uint8_t last          = IGNORE_CASE ? fold_ascii(needle[m - 1]) : needle[m - 1];
+    auto matches_at             = [&](std::size_t at) {
+        return m <= 2 || substring_equal<IGNORE_CASE>(haystack + at + 1, needle + 1, m - 2);
+    };
+
+#ifdef __AVX2__
+    if (positions >= 32) {
+        const __m256i firsts = _mm256_set1_epi8(static_cast<char>(first));
+        const __m256i lasts  = _mm256_set1_epi8(static_cast<char>(last));
+        auto step            = [&](std::size_t i) {
+            const uint8_t *p   = haystack + i;
+            const __m256i head = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            const __m256i tail = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + m - 1));
+            const __m256i both = _mm256_and_si256(
+                _mm256_cmpeq_epi8(firsts, fold_ascii_vector<IGNORE_CASE>(head)),
+                _mm256_cmpeq_epi8(lasts, fold_ascii_vector<IGNORE_CASE>(tail))
+            );
+            for (uint32_t mask = _mm256_movemask_epi8(both); mask != 0; mask &= mask - 1) {
+                if (matches_at(i + __builtin_ctz(mask))) {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        std::size_t i = 0;
+        for (; i + 32 <= positions; i += 32) {
+            if (step(i)) {
+                return true;
+            }
+        }
+        // The remaining positions are covered by one step overlapping the previous one
+        return i < positions && step(positions - 32);
+    }
+#endif
+    for (std::size_t i = 0; i < positions; i++) {
+        const uint8_t a = IGNORE_CASE ? fold_ascii(haystack[i]) : haystack[i];
+        const uint8_t b = IGNORE_CASE ? fold_ascii(haystack[i + m - 1]) : haystack[i + m - 1];
+        if (a == first && b == last && matches_at(i)) {
+            return true;
+        }
+    }
+    return false;
+}